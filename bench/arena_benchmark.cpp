@@ -0,0 +1,70 @@
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "../include/biginteger.hpp"
+
+namespace {
+
+    //Обработка одного "запроса": разбор, арифметика с временными числами и печать ответа
+    std::string handle_request(const std::string& left, const std::string& right) {
+        const BigInteger a(left);
+        const BigInteger b(right);
+        BigInteger accumulator = a * b;
+        for (int i = 1; i <= 16; ++i) {
+            accumulator += (a + i) * (b - i);
+            accumulator -= (a << i) + b;
+        }
+        return to_string(accumulator / (b + 1));
+    }
+
+    template<class Handler>
+    double milliseconds(Handler handler) {
+        const auto start = std::chrono::steady_clock::now();
+        handler();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main() {
+    std::vector<std::string> operands;
+    for (int i = 0; i < 64; ++i) {
+        std::string digits(40 + 3 * i, '0');
+        for (size_t j = 0; j < digits.size(); ++j) {
+            digits[j] = static_cast<char>('1' + (i * 31 + j * 17) % 9);
+        }
+        operands.push_back(digits);
+    }
+    constexpr int requests = 100000;
+
+    //Память по умолчанию: временные числа берут и возвращают блоки пула лимбов потока
+    size_t checksum = 0;
+    const double pool_time = milliseconds([&] {
+        for (int r = 0; r < requests; ++r) {
+            checksum += handle_request(operands[r % 64], operands[(r * 7 + 3) % 64]).size();
+        }
+    });
+
+    //Монотонный буфер на запрос: выделение - сдвиг указателя, освобождение - ничего,
+    //вся память запроса отдаётся одним release()
+    size_t arena_checksum = 0;
+    std::vector<std::byte> buffer(1 << 16);
+    const double arena_time = milliseconds([&] {
+        std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+        for (int r = 0; r < requests; ++r) {
+            {
+                const MemoryResourceScope scope(&arena);
+                arena_checksum += handle_request(operands[r % 64], operands[(r * 7 + 3) % 64]).size();
+            }
+            arena.release();
+        }
+    });
+    assert(checksum == arena_checksum);
+
+    std::cout << requests << " requests, limb pool:        " << pool_time << " ms\n";
+    std::cout << requests << " requests, monotonic arena:  " << arena_time << " ms\n";
+    return 0;
+}
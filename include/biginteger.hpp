@@ -1,31 +1,211 @@
 #ifndef BIG_INTEGER_HPP
 #define BIG_INTEGER_HPP
 #pragma once
+#include <bit>
+#include <charconv>
+#include <compare>
+#include <concepts>
 #include <cstdint>
+#include <memory_resource>
+#include <span>
 #include <string>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <version>
 
-enum class biginteger_base { hex, dec };
+enum class biginteger_base { hex, dec, bin, oct };
+
+//Встроенные целые для смешанной арифметики - ровно те, что принимает std::cmp_less.
+//bool и символьные типы идут, как и раньше, через преобразование в BigInteger(int)
+template<class T>
+concept biginteger_small_integer = std::integral<T>
+    && !std::same_as<std::remove_cv_t<T>, bool>
+    && !std::same_as<std::remove_cv_t<T>, char>
+    && !std::same_as<std::remove_cv_t<T>, wchar_t>
+    && !std::same_as<std::remove_cv_t<T>, char8_t>
+    && !std::same_as<std::remove_cv_t<T>, char16_t>
+    && !std::same_as<std::remove_cv_t<T>, char32_t>;
+
+//Счётчики пула лимбов текущего потока (BigInteger::pool_statistics)
+struct biginteger_pool_statistics {
+    size_t hits = 0;         //выделения, обслуженные из кэша
+    size_t misses = 0;       //выделения, ушедшие в operator new
+    size_t cached_bytes = 0; //байт в кэше сейчас
+};
+
+class MontgomeryContext;
+class BarrettReducer;
+
+//Пороги (в лимбах меньшего операнда) переключения алгоритмов
+struct biginteger_thresholds {
+    size_t karatsuba = 24;
+    size_t toom3 = 250;
+    size_t toom4 = 700;
+    size_t ntt = 30000;
+    size_t burnikel_ziegler = 150; //ниже столбик Кнута не медленнее рекурсии
+    size_t newton_division = 500000; //Ньютон (с умножением через NTT) обгоняет Бурникеля - Циглера около 2^25 бит
+    size_t radix_conversion = 40; //в блоках по 19 десятичных цифр (или в лимбах)
+    size_t karatsuba_square = 56; //квадрат в столбик вдвое дешевле, поэтому его порог выше
+    size_t half_gcd = 600;
+    size_t burnikel_ziegler_block = 40; //блок, на котором рекурсия Бурникеля - Циглера переходит к столбику
+};
 
 class BigInteger {
 
+    //Лимб - 64-битное слово; наружу через get_data() число отдаётся 32-битными словами
+    using limb_t = uint64_t;
+
+    //Число из не более чем INLINE_LIMBS лимбов хранится в самом объекте, без обращения к куче
+    static constexpr size_t INLINE_LIMBS = 2;
+
     //Поля класса
-    uint32_t* data;
-    size_t size;
+    union {
+        limb_t* heap;
+        limb_t local[INLINE_LIMBS] = {};
+    };
+    size_t size = 1;
+    size_t capacity = INLINE_LIMBS; //capacity > INLINE_LIMBS означает, что лимбы лежат в heap
     bool is_negative = false;
+    //Источник памяти heap: берётся при создании числа и не меняется до его уничтожения
+    std::pmr::memory_resource* resource = default_memory_resource();
 
+    bool is_inline() const { return capacity <= INLINE_LIMBS; }
+    limb_t* limbs() { return is_inline() ? local : heap; }
+    const limb_t* limbs() const { return is_inline() ? local : heap; }
 
-    //Функция увеличения памяти
+    //Функция изменения длины: новые лимбы заполняются нулями, память растёт геометрически
     void resize(size_t new_size);
 
+    //Резервирование памяти в 64-битных лимбах
+    void reserve_limbs(size_t new_capacity);
+
+    //Выделение и освобождение буфера лимбов через resource
+    limb_t* allocate_limbs(size_t count);
+    void deallocate_limbs(limb_t* data, size_t count);
+
+    //Источник памяти по умолчанию: кэш освобождённых буферов в каждом потоке по классам размеров
+    //(степени двойки от 32 байт до 1 МиБ). Буфер, выделенный в одном потоке, может быть возвращён
+    //в кэш другого, так что числа свободно переходят между потоками
+    static std::pmr::memory_resource* limb_pool();
+
+    //Освобождение кучи и возврат к пустому встроенному буферу
+    void release();
+
+    //Запись модуля из одного лимба
+    void assign_magnitude(uint64_t magnitude);
+
     void create_from_dec_string(const std::string& str);
 
-    void create_from_hex_string(const std::string& str);
+    //Разбор в системе с основанием 2^bits_per_digit (двоичная, восьмеричная, шестнадцатеричная)
+    void create_from_power_of_two_string(const char* first, const char* last, unsigned bits_per_digit);
+
+    //*this += a * b (при subtract - *this -= a * b) без промежуточных объектов
+    BigInteger& multiply_accumulate(const BigInteger& a, const BigInteger& b, bool subtract);
+
+    //*this += |other|, взятое со знаком other_negative. Буфер растёт на лимб только при переносе из старшего разряда
+    void add_signed(const limb_t* other_data, size_t other_size, bool other_negative);
+
+    //Модуль встроенного целого (у INT64_MIN - 2^63)
+    template<biginteger_small_integer T>
+    static constexpr uint64_t small_magnitude(T value) {
+        if constexpr (std::is_signed_v<T>) {
+            return std::cmp_less(value, 0) ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+        }
+        else {
+            return static_cast<uint64_t>(value);
+        }
+    }
+
+    //Операции с числом ±magnitude из одного лимба без создания BigInteger
+    void add_small(uint64_t magnitude, bool negative);
+    void multiply_small(uint64_t magnitude, bool negative);
+
+    //*this = *this / (±magnitude) с усечением к нулю
+    void divide_small(uint64_t magnitude, bool negative);
+
+    //|*this| mod magnitude без изменения *this (знак остатка - знак делимого)
+    uint64_t remainder_small(uint64_t magnitude) const;
+
+    //Знак *this - (±magnitude): -1, 0 или 1
+    int compare_small(uint64_t magnitude, bool negative) const;
+
+    //Умножение модулей: result занимает a_size + b_size лимбов, a_size >= b_size
+    static void multiply_magnitudes(limb_t* result, const limb_t* a, size_t a_size,
+        const limb_t* b, size_t b_size);
+
+    static void multiply_unbalanced(limb_t* result, const limb_t* a, size_t a_size,
+        const limb_t* b, size_t b_size);
+
+    static void multiply_karatsuba(limb_t* result, const limb_t* a, size_t a_size,
+        const limb_t* b, size_t b_size);
+
+    static void multiply_toom(limb_t* result, const limb_t* a, size_t a_size,
+        const limb_t* b, size_t b_size, size_t parts);
+
+    static void multiply_ntt(limb_t* result, const limb_t* a, size_t a_size,
+        const limb_t* b, size_t b_size);
+
+    static BigInteger from_limbs(const limb_t* source, size_t count);
+
+    //Копия value с запасом extra_limbs лимбов сверх known_limbs (под перенос или сдвиг). Пока known_limbs
+    //помещается во встроенный буфер, запас не резервируется: результат обычно остаётся встроенным,
+    //а редкий перенос стоит одного выделения - столько же, сколько резерв
+    static BigInteger copy_with_room(const BigInteger& value, size_t known_limbs, size_t extra_limbs);
 
-    static bool isAbsLess(const BigInteger& left, const BigInteger& right);
+    static BigInteger shift_limbs(const BigInteger& value, long long count);
 
-    static void absolute_difference(uint32_t*& data, size_t& size,
-        const uint32_t* other_data, size_t other_size);
+    static size_t recursion_block();
+
+    static BigInteger newton_reciprocal(const limb_t* divisor, size_t n, size_t k);
+
+    static void divide_2n_by_n(limb_t* quotient, limb_t* numerator, const limb_t* divisor, size_t n);
+
+    static void divide_3n_by_2n(limb_t* quotient, limb_t* numerator, const limb_t* divisor, size_t half);
+
+    //chunk^(2^level), где chunk - наибольшая степень base, помещающаяся в лимб (10^19 для base = 10).
+    //Степени кэшируются в пределах потока
+    static const BigInteger& power_of_radix(uint32_t base, size_t level);
+
+    //Число из блоков по chunk (младший блок первый) разбиением пополам по степеням power_of_radix
+    static BigInteger from_radix_chunks(const limb_t* chunks, size_t count, uint32_t base);
+
+    //Разбор уже проверенных цифр в системе с основанием 2..36 в неотрицательное *this.
+    //Короткие числа собираются прямо в текущем буфере, без выделения памяти
+    void assign_digits(const char* first, const char* last, uint32_t base);
+
+    //Запись |value| ровно в width символов [first, first + width) с ведущими нулями.
+    //Если цифр больше width, пишутся младшие width из них и возвращается false
+    static bool write_digits(const BigInteger& value, char* first, size_t width, uint32_t base,
+        const char* alphabet);
+
+    //Запись со знаком в [first, last) без ведущих нулей
+    static std::to_chars_result write_number(char* first, char* last, const BigInteger& value, int base,
+        const char* alphabet);
+
+    enum class bit_operation { conjunction, disjunction, exclusive };
+
+    //*this = *this & other (| или ^) в дополнительном коде (отрицательные числа дополнены единицами слева).
+    //Для неотрицательных операндов результат пишется в собственный буфер
+    void bitwise_assign(const BigInteger& other, bit_operation operation);
+
+    //Шаги Евклида методом Лемера над u >= v >= 0 по старшим 127 битам, пока v длиннее stop_bits бит
+    //(stop_bits = 0 - до v = 0). matrix (если задан) получает знаковую матрицу преобразования
+    //(u', v') = [m0 m1; m2 m3] (u, v); при columns = 1 считается только первый столбец (m0, m2)
+    static void lehmer_reduce(BigInteger& u, BigInteger& v, BigInteger* matrix, size_t columns, size_t stop_bits);
+
+    //Половинный НОД: u >= v >= 0 сокращаются до v < 2^(bits(u) / 2 + 1) двумя рекурсивными
+    //вызовами на старших половинах; matrix - как в lehmer_reduce
+    static void half_gcd(BigInteger& u, BigInteger& v, BigInteger* matrix);
+
+    //Алгоритм Евклида до u = НОД, v = 0 при u >= v >= 0. cofactors (если задан) - пара (x, y),
+    //преобразуемая той же матрицей, что и (u, v)
+    static void euclid(BigInteger& u, BigInteger& v, BigInteger* cofactors);
+
+    //Деление модулей при a >= b: quotient занимает a_size - b_size + 1 лимбов, remainder - b_size
+    static void divide_magnitudes(limb_t* quotient, limb_t* remainder, const limb_t* a, size_t a_size,
+        const limb_t* b, size_t b_size);
 public:
     //-------------------------------------К О Н С Т Р У К Т О Р Ы-----------------------------------------------------------
     BigInteger();
@@ -38,25 +218,34 @@ public:
     BigInteger(const BigInteger& other);
     BigInteger(BigInteger&& other) noexcept;
     BigInteger(std::string str, biginteger_base base = biginteger_base::dec);
+
+    //Нулевое число, лимбы которого будут выделяться из resource (nullptr - пул лимбов)
+    explicit BigInteger(std::pmr::memory_resource* resource);
     ~BigInteger();
 
     //------------------------------------------------О П Е Р А Т О Р Ы-------------------------------------------------------------
         //Оператор присваивания
     BigInteger& operator=(const BigInteger& other);
 
-    //Оператор перемещения
-    BigInteger& operator=(BigInteger&& other) noexcept;
+    //Оператор перемещения. Буфер забирается, только если у other тот же источник памяти,
+    //иначе лимбы копируются в собственную память (как у std::pmr-контейнеров)
+    BigInteger& operator=(BigInteger&& other);
 
-    //Унарные операторы
-    BigInteger operator-() const;
+    //Унарные операторы; у временного объекта знак меняется на месте
+    BigInteger operator-() const&;
+    BigInteger operator-() &&;
     BigInteger operator+() const;
 
-    //Операторы сравнения
-    bool operator!=(const BigInteger& other) const;
-    bool operator<(const BigInteger& other) const;
-    bool operator<=(const BigInteger& other) const;
-    bool operator>(const BigInteger& other) const;
-    bool operator>=(const BigInteger& other) const;
+    //Сравнение со встроенными целыми за O(1) (знак, длина и единственный лимб), без временного BigInteger;
+    //<, <=, >, >=, != и обратный порядок операндов выводятся компилятором
+    template<biginteger_small_integer T>
+    bool operator==(T other) const;
+    template<biginteger_small_integer T>
+    std::strong_ordering operator<=>(T other) const;
+
+    //Трёхстороннее сравнение за один проход от старшего лимба: знак и длина решают без прохода.
+    //<, <=, >, >= выводятся из него, != - из operator==
+    std::strong_ordering operator<=>(const BigInteger& other) const;
 
     //Инкремент и декремент
     BigInteger& operator++();
@@ -71,35 +260,491 @@ public:
     BigInteger& operator/=(const BigInteger& divisor);
     BigInteger& operator%=(const BigInteger& other);
 
+    //Арифметика со встроенными целыми на месте ядрами одного лимба (add, mul_1, divrem_1)
+    template<biginteger_small_integer T>
+    BigInteger& operator+=(T other);
+    template<biginteger_small_integer T>
+    BigInteger& operator-=(T other);
+    template<biginteger_small_integer T>
+    BigInteger& operator*=(T other);
+    template<biginteger_small_integer T>
+    BigInteger& operator/=(T divisor);
+    template<biginteger_small_integer T>
+    BigInteger& operator%=(T other);
+    template<biginteger_small_integer T>
+    friend BigInteger operator%(const BigInteger& left, T right);
+
+    //Слитные операции: *this += a * b и *this -= a * b. Произведение пишется сразу в буфер *this
+    //(если он нулевой) или во временный буфер (на стеке или из default_memory_resource()) и прибавляется к лимбам *this на месте.
+    //Выражение a*b + c*d - e без временных объектов: mul_add(a, b, -e).addmul(c, d)
+    BigInteger& addmul(const BigInteger& a, const BigInteger& b);
+    BigInteger& submul(const BigInteger& a, const BigInteger& b);
+
+    //Побитовые операторы в дополнительном коде, как в GMP: ~x == -x - 1,
+    //x >> n - деление на 2^n с округлением вниз, x << n - умножение на 2^n
+    BigInteger operator~() const;
+    BigInteger& operator&=(const BigInteger& other);
+    BigInteger& operator|=(const BigInteger& other);
+    BigInteger& operator^=(const BigInteger& other);
+    BigInteger& operator<<=(size_t bits);
+    BigInteger& operator>>=(size_t bits);
+
     //------------------------------------------------Г Е Т Т Е Р Ы   И   С Е Т Т Е Р Ы---------------------------------------------------------
-        //Геттеры
+        //Геттеры. get_size() и get_data() описывают модуль 32-битными словами (младшее первое);
+        //слова собираются из лимбов сдвигами, поэтому порядок не зависит от платформы
     bool get_is_negative() const;
     size_t get_size() const;
-    const uint32_t* get_data() const;
+    size_t get_capacity() const;
+    std::vector<uint32_t> get_data() const;
+    //Без выделения памяти: пишет min(words.size(), get_size()) младших слов и возвращает их число
+    size_t get_data(std::span<uint32_t> words) const;
 
     //Сеттер
     void set_is_negative(bool set_value);
 
     //---------------------------------------------Д О П О Л Н И Т Е Л Ь Н О-------------------------------------------------
     BigInteger abs() const;
+
+    //Проверки за O(1): у нуля ровно один нулевой лимб и нет знака
     bool isZero() const;
+    int sign() const;
     int divide_by_10();
     int divide_by_16();
+
+    //x * x: попарные произведения лимбов считаются один раз (то же происходит в x *= x и x * x)
+    BigInteger square() const;
+
+    //Число бит в |x| (у нуля - 0)
+    size_t bit_length() const;
+
+    //Число единичных битов |x|; у отрицательного числа их бесконечно много, возвращается SIZE_MAX (как в GMP)
+    size_t popcount() const;
+
+    //Бит с номером index в дополнительном коде
+    bool test_bit(size_t index) const;
+
+    //Управление памятью (в 32-битных словах, как get_size): reserve не уменьшает буфер, shrink_to_fit отдаёт лишнее
+    void reserve(size_t new_capacity);
+    void shrink_to_fit();
+
+    //Источник памяти, из которого выделены лимбы этого числа
+    std::pmr::memory_resource* get_memory_resource() const;
+
+    //Источник памяти новых чисел и рабочих буферов в текущем потоке (по умолчанию - пул лимбов).
+    //Число запоминает источник при создании, копия получает текущий источник потока, перемещение - источник
+    //оригинала. set_default_memory_resource возвращает прежний источник; nullptr восстанавливает пул
+    static std::pmr::memory_resource* default_memory_resource();
+    static std::pmr::memory_resource* set_default_memory_resource(std::pmr::memory_resource* resource);
+
+    //Попадания и промахи пула лимбов в текущем потоке. set_pool_limit задаёт предел байт в кэше
+    //каждого потока (по умолчанию 4 МиБ); освобождаемые сверх предела буферы отдаются operator delete
+    static biginteger_pool_statistics pool_statistics();
+    static void set_pool_limit(size_t bytes);
+
+    //left < right, то же, что (left <=> right) < 0
     static bool isLess(const BigInteger& left, const BigInteger& right);
+
+    //Частное (с усечением к нулю) и остаток (со знаком делимого) за одно деление
+    static void divmod(const BigInteger& dividend, const BigInteger& divisor,
+        BigInteger& quotient, BigInteger& remainder);
+
+    //Настраиваемые пороги алгоритмов
+    static biginteger_thresholds& thresholds();
+
+    //Вариант низкоуровневых ядер под набор инструкций: "generic", "x86-64", "adx", "avx2" или "avx512".
+    //По умолчанию выбирается по CPUID лучший поддерживаемый, переменная окружения BIGINTEGER_KERNELS
+    //задаёт его при запуске (неверное значение переменной - сообщение в stderr и автоматический выбор).
+    //set_kernel_variant("auto") возвращает автоматический выбор; неизвестное или неподдерживаемое
+    //процессором имя в set_kernel_variant - std::invalid_argument
+    static std::string kernel_variant();
+    static void set_kernel_variant(const std::string& name);
+
+    friend bool operator==(const BigInteger& left, const BigInteger& right);
+    friend BigInteger operator+(const BigInteger& left, const BigInteger& right);
+    friend BigInteger operator-(const BigInteger& left, const BigInteger& right);
+    friend BigInteger operator<<(const BigInteger& value, size_t bits);
+    template<biginteger_small_integer T>
+    friend BigInteger operator*(const BigInteger& left, T right);
+    friend BigInteger mul_add(const BigInteger& a, const BigInteger& b, const BigInteger& c);
+    friend class MontgomeryContext;
+    friend BigInteger gcd(const BigInteger& a, const BigInteger& b);
+    friend void xgcd(const BigInteger& a, const BigInteger& b, BigInteger& g, BigInteger& s, BigInteger& t);
+    friend class BarrettReducer;
+    friend std::string to_string(const BigInteger& b_int, biginteger_base base);
+    friend std::to_chars_result to_chars(char* first, char* last, const BigInteger& value, int base);
+    friend std::from_chars_result from_chars(const char* first, const char* last, BigInteger& value, int base);
+};
+
+//Источник памяти новых чисел потока на время жизни объекта. Например, все временные числа
+//обработки запроса берутся из std::pmr::monotonic_buffer_resource и освобождаются вместе с ним.
+//Числа, созданные внутри области, не должны пережить сам источник: результат копируется или
+//перемещается в число, созданное вне области
+class MemoryResourceScope {
+    std::pmr::memory_resource* previous;
+public:
+    explicit MemoryResourceScope(std::pmr::memory_resource* resource);
+    ~MemoryResourceScope();
+    MemoryResourceScope(const MemoryResourceScope&) = delete;
+    MemoryResourceScope& operator=(const MemoryResourceScope&) = delete;
 };
+
+//Умножение по нечётному модулю N в форме Монтгомери (x -> x * R mod N, R = 2^(64 * лимбы N)).
+//n' = -N^(-1) mod 2^64 и R^2 mod N считаются один раз; контекст можно переиспользовать для многих возведений
+class MontgomeryContext {
+    BigInteger modulus_value;
+    BigInteger r_squared;
+    uint64_t inverse = 0; //n'
+    size_t n = 1;         //лимбов в модуле
+
+    //result = a * b * R^(-1) mod N над буферами по n лимбов; scratch - 2n лимбов. result может совпадать с a или b
+    void multiply(uint64_t* result, const uint64_t* a, const uint64_t* b, uint64_t* scratch) const;
+
+    //REDC: result = t * R^(-1) mod N для t < N * R (2n лимбов, t портится)
+    void reduce(uint64_t* result, uint64_t* t) const;
+
+    //|value| mod N (с учётом знака) в буфер из n лимбов
+    void load(uint64_t* target, const BigInteger& value) const;
+public:
+    //Модуль - нечётное положительное число, иначе std::invalid_argument
+    explicit MontgomeryContext(const BigInteger& modulus);
+
+    const BigInteger& modulus() const;
+
+    //Перевод в форму Монтгомери и обратно
+    BigInteger to_montgomery(const BigInteger& value) const;
+    BigInteger from_montgomery(const BigInteger& value) const;
+
+    //Произведение чисел в форме Монтгомери (результат тоже в форме Монтгомери)
+    BigInteger multiply(const BigInteger& left, const BigInteger& right) const;
+
+    //base^exponent mod N (обычные числа на входе и выходе) со скользящим окном; exponent >= 0
+    BigInteger pow(const BigInteger& base, const BigInteger& exponent) const;
+};
+
+//Приведение по фиксированному модулю N (n лимбов) методом Барретта: mu = floor(B^(2n) / N) считается один раз,
+//далее остаток числа меньше B^(2n) (в частности, меньше N^2) получается двумя умножениями без деления
+class BarrettReducer {
+    BigInteger modulus_value;
+    BigInteger reciprocal; //mu
+    size_t n = 1;
+
+    //value = value mod N на месте; scratch - scratch_size() лимбов
+    void reduce_in_place(BigInteger& value, uint64_t* scratch) const;
+    size_t scratch_size() const;
+public:
+    //Модуль - положительное число, иначе std::invalid_argument
+    explicit BarrettReducer(const BigInteger& modulus);
+
+    const BigInteger& modulus() const;
+
+    //value mod N в диапазоне [0, N). Отрицательные числа приводятся по модулю их абсолютной величины,
+    //числа не меньше B^(2n) - обычным делением
+    BigInteger reduce(const BigInteger& value) const;
+
+    //Приведение всех элементов на месте с общим рабочим буфером
+    void reduce(std::span<BigInteger> values) const;
+};
+
 //-----------------------------------------------------------В Н Е Ш Н И Е----------------------------------------------------------------
 
-//Бинарный оператор сравнения
+//Равенство: знак и длина, затем лимбы
 bool operator==(const BigInteger& left, const BigInteger& right);
 
 std::string to_string(const BigInteger& b_int);
 std::string to_hex(const BigInteger& b_int);
+std::string to_string(const BigInteger& b_int, biginteger_base base);
 
-//Бинарные арифметические операторы
+//Запись и разбор в системах счисления 2..36 в буфере вызывающего, по образцу std::to_chars / std::from_chars.
+//to_chars пишет '-' и цифры (строчные буквы), при нехватке места возвращает std::errc::value_too_large.
+//from_chars принимает необязательный '-' и наибольшую последовательность цифр; без цифр value не меняется
+std::to_chars_result to_chars(char* first, char* last, const BigInteger& value, int base = 10);
+std::from_chars_result from_chars(const char* first, const char* last, BigInteger& value, int base = 10);
+
+//Верхняя оценка числа цифр |value| (без знака): точная для оснований 2^k, иначе больше не более чем на 1
+size_t size_in_base(const BigInteger& value, int base);
+
+//Бинарные арифметические операторы. Перегрузки с BigInteger&& считают результат в буфере
+//истекающего операнда: std::move(a) + b и a - f(b) не выделяют памяти, если её хватает
 BigInteger operator+(const BigInteger& left, const BigInteger& right);
+BigInteger operator+(BigInteger&& left, const BigInteger& right);
+BigInteger operator+(const BigInteger& left, BigInteger&& right);
+BigInteger operator+(BigInteger&& left, BigInteger&& right);
 BigInteger operator-(const BigInteger& left, const BigInteger& right);
+BigInteger operator-(BigInteger&& left, const BigInteger& right);
+BigInteger operator-(const BigInteger& left, BigInteger&& right);
+BigInteger operator-(BigInteger&& left, BigInteger&& right);
 BigInteger operator*(const BigInteger& left, const BigInteger& right);
+BigInteger operator*(BigInteger&& left, const BigInteger& right);
+BigInteger operator*(const BigInteger& left, BigInteger&& right);
+BigInteger operator*(BigInteger&& left, BigInteger&& right);
 BigInteger operator/(const BigInteger& left, const BigInteger& right);
+BigInteger operator/(BigInteger&& left, const BigInteger& right);
 BigInteger operator%(const BigInteger& left, const BigInteger& right);
+BigInteger operator%(BigInteger&& left, const BigInteger& right);
+
+//base^exponent mod modulus в диапазоне [0, modulus). Нечётный модуль - через MontgomeryContext,
+//чётный 2^s * q - по китайской теореме об остатках из остатков по q и по 2^s.
+//exponent < 0 или modulus <= 0 - std::invalid_argument
+BigInteger pow_mod(const BigInteger& base, const BigInteger& exponent, const BigInteger& modulus);
+
+//Наибольший общий делитель (неотрицательный, gcd(0, 0) = 0) и наименьшее общее кратное (неотрицательное).
+//Лемер по старшим двум лимбам, для длинных чисел - половинный НОД
+BigInteger gcd(const BigInteger& a, const BigInteger& b);
+BigInteger lcm(const BigInteger& a, const BigInteger& b);
+
+//Расширенный алгоритм Евклида: g = gcd(a, b) = s * a + t * b, |s| <= |b| / (2g) при b != 0
+void xgcd(const BigInteger& a, const BigInteger& b, BigInteger& g, BigInteger& s, BigInteger& t);
+
+//a^(-1) mod modulus в диапазоне [0, modulus). Необратимое a или modulus <= 0 - std::invalid_argument
+BigInteger mod_inverse(const BigInteger& a, const BigInteger& modulus);
+
+//Целый квадратный корень floor(sqrt(value)) и остаток value - root^2 (корень Циммермана: деления
+//вдвое меньшей длины на каждом уровне). Отрицательное value - std::invalid_argument
+BigInteger isqrt(const BigInteger& value);
+void sqrtrem(const BigInteger& value, BigInteger& root, BigInteger& remainder);
+
+//Корень степени k >= 1 с усечением к нулю (метод Ньютона с удвоением точности).
+//k = 0 или корень чётной степени из отрицательного числа - std::invalid_argument
+BigInteger iroot(const BigInteger& value, unsigned long k);
+
+//Проверка на полный квадрат; большинство неквадратов отсекается по остаткам до извлечения корня
+bool is_perfect_square(const BigInteger& value);
+
+//n!, C(n, k) (0 при k > n) и n# (произведение простых до n включительно). Множители берутся из решета,
+//n! - через простое качание Люшни, все произведения - сбалансированным деревом
+BigInteger factorial(unsigned long n);
+BigInteger binomial(unsigned long n, unsigned long k);
+BigInteger primorial(unsigned long n);
+
+//a * b + c с единственным выделением памяти под результат
+BigInteger mul_add(const BigInteger& a, const BigInteger& b, const BigInteger& c);
+
+//Бинарные побитовые операторы; перегрузки с BigInteger&& работают в буфере истекающего операнда
+BigInteger operator&(const BigInteger& left, const BigInteger& right);
+BigInteger operator&(BigInteger&& left, const BigInteger& right);
+BigInteger operator&(const BigInteger& left, BigInteger&& right);
+BigInteger operator&(BigInteger&& left, BigInteger&& right);
+BigInteger operator|(const BigInteger& left, const BigInteger& right);
+BigInteger operator|(BigInteger&& left, const BigInteger& right);
+BigInteger operator|(const BigInteger& left, BigInteger&& right);
+BigInteger operator|(BigInteger&& left, BigInteger&& right);
+BigInteger operator^(const BigInteger& left, const BigInteger& right);
+BigInteger operator^(BigInteger&& left, const BigInteger& right);
+BigInteger operator^(const BigInteger& left, BigInteger&& right);
+BigInteger operator^(BigInteger&& left, BigInteger&& right);
+BigInteger operator<<(const BigInteger& value, size_t bits);
+BigInteger operator<<(BigInteger&& value, size_t bits);
+BigInteger operator>>(const BigInteger& value, size_t bits);
+BigInteger operator>>(BigInteger&& value, size_t bits);
+
+//----------------------------------------С М Е Ш А Н Н А Я   А Р И Ф М Е Т И К А---------------------------------------------------------
+//Операнд встроенного целого типа не превращается в BigInteger: работают ядра одного лимба
+
+template<biginteger_small_integer T>
+bool BigInteger::operator==(T other) const {
+    return compare_small(small_magnitude(other), std::cmp_less(other, 0)) == 0;
+}
+
+template<biginteger_small_integer T>
+std::strong_ordering BigInteger::operator<=>(T other) const {
+    return compare_small(small_magnitude(other), std::cmp_less(other, 0)) <=> 0;
+}
+
+template<biginteger_small_integer T>
+BigInteger& BigInteger::operator+=(T other) {
+    add_small(small_magnitude(other), std::cmp_less(other, 0));
+    return *this;
+}
+
+template<biginteger_small_integer T>
+BigInteger& BigInteger::operator-=(T other) {
+    add_small(small_magnitude(other), !std::cmp_less(other, 0));
+    return *this;
+}
+
+template<biginteger_small_integer T>
+BigInteger& BigInteger::operator*=(T other) {
+    multiply_small(small_magnitude(other), std::cmp_less(other, 0));
+    return *this;
+}
+
+template<biginteger_small_integer T>
+BigInteger& BigInteger::operator/=(T divisor) {
+    divide_small(small_magnitude(divisor), std::cmp_less(divisor, 0));
+    return *this;
+}
+
+template<biginteger_small_integer T>
+BigInteger& BigInteger::operator%=(T other) {
+    const uint64_t remainder = remainder_small(small_magnitude(other));
+    assign_magnitude(remainder);
+    is_negative = is_negative && remainder != 0;
+    return *this;
+}
+
+template<biginteger_small_integer T>
+BigInteger operator+(const BigInteger& left, T right) {
+    BigInteger result = left;
+    result += right;
+    return result;
+}
+template<biginteger_small_integer T>
+BigInteger operator+(BigInteger&& left, T right) {
+    left += right;
+    return std::move(left);
+}
+template<biginteger_small_integer T>
+BigInteger operator+(T left, const BigInteger& right) {
+    return right + left;
+}
+template<biginteger_small_integer T>
+BigInteger operator+(T left, BigInteger&& right) {
+    right += left;
+    return std::move(right);
+}
+template<biginteger_small_integer T>
+BigInteger operator-(const BigInteger& left, T right) {
+    BigInteger result = left;
+    result -= right;
+    return result;
+}
+template<biginteger_small_integer T>
+BigInteger operator-(BigInteger&& left, T right) {
+    left -= right;
+    return std::move(left);
+}
+template<biginteger_small_integer T>
+BigInteger operator-(T left, const BigInteger& right) {
+    // left - right = -(right - left)
+    return -(right - left);
+}
+template<biginteger_small_integer T>
+BigInteger operator-(T left, BigInteger&& right) {
+    right -= left;
+    return -std::move(right);
+}
+template<biginteger_small_integer T>
+BigInteger operator*(const BigInteger& left, T right) {
+    //Копия сразу получает место под лимб переноса
+    BigInteger result = BigInteger::copy_with_room(left, left.size, 1);
+    result *= right;
+    return result;
+}
+template<biginteger_small_integer T>
+BigInteger operator*(BigInteger&& left, T right) {
+    left *= right;
+    return std::move(left);
+}
+template<biginteger_small_integer T>
+BigInteger operator*(T left, const BigInteger& right) {
+    return right * left;
+}
+template<biginteger_small_integer T>
+BigInteger operator*(T left, BigInteger&& right) {
+    right *= left;
+    return std::move(right);
+}
+template<biginteger_small_integer T>
+BigInteger operator/(BigInteger left, T right) {
+    left /= right;
+    return left;
+}
+template<biginteger_small_integer T>
+BigInteger operator%(const BigInteger& left, T right) {
+    //Остаток меньше делителя и помещается во встроенный буфер; копия делимого не нужна
+    const uint64_t remainder = left.remainder_small(BigInteger::small_magnitude(right));
+    BigInteger result = remainder;
+    result.is_negative = left.is_negative && remainder != 0;
+    return result;
+}
+template<biginteger_small_integer T>
+BigInteger operator%(BigInteger&& left, T right) {
+    left %= right;
+    return std::move(left);
+}
+
+//Форматирование через std::format: {}, {:d}, {:x}, {:X}, {:o}, {:b}
+#if defined(__cpp_lib_format)
+#include <algorithm>
+#include <format>
+#include <iterator>
+
+//Поддерживается [[fill]align][width][type]: align - '<', '>' или '^' (по умолчанию вправо, как у чисел),
+//type - d, x, X, o, b. Знак, '#', '0' и ширина через {} не поддерживаются
+template<>
+struct std::formatter<BigInteger, char> {
+    int base = 10;
+    bool uppercase = false;
+    char fill = ' ';
+    char align = '>';
+    size_t width = 0;
+
+    constexpr std::format_parse_context::iterator parse(std::format_parse_context& context) {
+        auto it = context.begin();
+        const auto end = context.end();
+        const auto is_align = [](char symbol) { return symbol == '<' || symbol == '>' || symbol == '^'; };
+        if (it != end && *it != '}' && std::next(it) != end && is_align(*std::next(it))) {
+            if (*it == '{') {
+                throw std::format_error("Invalid fill character for BigInteger");
+            }
+            fill = *it;
+            align = *std::next(it);
+            it += 2;
+        } else if (it != end && is_align(*it)) {
+            align = *it;
+            ++it;
+        }
+        while (it != end && *it >= '0' && *it <= '9') {
+            if (width == 0 && *it == '0') {
+                throw std::format_error("Zero padding is not supported for BigInteger");
+            }
+            width = width * 10 + static_cast<size_t>(*it - '0');
+            ++it;
+        }
+        if (it != end && *it != '}') {
+            switch (*it) {
+            case 'd': base = 10; break;
+            case 'x': base = 16; break;
+            case 'X': base = 16; uppercase = true; break;
+            case 'o': base = 8; break;
+            case 'b': base = 2; break;
+            default: throw std::format_error("Invalid format specifier for BigInteger");
+            }
+            ++it;
+        }
+        if (it != end && *it != '}') {
+            throw std::format_error("Invalid format specifier for BigInteger");
+        }
+        return it;
+    }
+
+    template<class FormatContext>
+    typename FormatContext::iterator format(const BigInteger& value, FormatContext& context) const {
+        //Небольшие числа форматируются в буфере на стеке
+        char stack_buffer[256];
+        std::string heap_buffer;
+        char* first = stack_buffer;
+        const size_t capacity = size_in_base(value, base) + 1;
+        if (capacity > sizeof(stack_buffer)) {
+            heap_buffer.resize(capacity);
+            first = heap_buffer.data();
+        }
+        char* last = ::to_chars(first, first + capacity, value, base).ptr;
+        if (uppercase) {
+            for (char* it = first; it != last; ++it) {
+                if (*it >= 'a' && *it <= 'z') {
+                    *it = static_cast<char>(*it - 'a' + 'A');
+                }
+            }
+        }
+        const size_t length = static_cast<size_t>(last - first);
+        const size_t padding = width > length ? width - length : 0;
+        const size_t before = align == '>' ? padding : (align == '^' ? padding / 2 : 0);
+        auto out = std::fill_n(context.out(), before, fill);
+        out = std::copy(first, last, out);
+        return std::fill_n(out, padding - before, fill);
+    }
+};
+#endif
 
 #endif
@@ -1,238 +1,183 @@
 #include "../include/biginteger.hpp"
+#include "kernels.hpp"
 #include <cstdint>
 #include <string>
 #include <stdexcept>
+#include <algorithm>
+#include <memory_resource>
+#include <utility>
+#include <vector>
 
 //---------------------------------------П Р И В А Т Н Ы Е   Ф У Н К Ц И И-------------------------------------------------------------
 
 //Функция увеличения памяти
 void BigInteger::resize(size_t new_size) {
-    uint32_t* new_data = new uint32_t[new_size]();
-    const size_t elements_to_copy = std::min(size, new_size);
-    for (size_t i = 0; i < elements_to_copy; ++i) {
-        new_data[i] = data[i];
+    const size_t elements_to_keep = std::min(size, new_size);
+    if (new_size > capacity) {
+        //Рост в полтора раза: при последовательном удлинении перевыделений O(log n)
+        reserve_limbs(std::max(new_size, capacity + capacity / 2));
     }
-    delete[] data;
-    data = new_data;
+    limb_t* data = limbs();
+    std::fill(data + elements_to_keep, data + new_size, 0);
     size = new_size;
 }
 
-void BigInteger::create_from_dec_string(const std::string& str) {
-    if (str.empty()) {
-        data = new uint32_t[1]{ 0 };
-        size = 1;
-        return;
+void BigInteger::release() {
+    if (!is_inline()) {
+        deallocate_limbs(heap, capacity);
+        capacity = INLINE_LIMBS;
     }
-    try {
-        size_t position = 0;
-        while (str[position] == '0' && position < str.size()) {
-            ++position;
+    local[0] = 0;
+    size = 1;
+}
+
+void BigInteger::assign_magnitude(uint64_t magnitude) {
+    //Модуль до 64 бит всегда помещается во встроенный буфер
+    limbs()[0] = magnitude;
+    size = 1;
+}
+
+void BigInteger::add_signed(const limb_t* other_data, size_t other_size, bool other_negative) {
+    //other_data может указывать на лимбы самого объекта (тогда длины равны): память перевыделяется
+    //только после того, как other_data прочитан
+    const size_t old_size = size;
+    if (is_negative == other_negative) {
+        const size_t max_size = std::max(old_size, other_size);
+        resize(max_size);
+        limb_t* data = limbs();
+        const limb_t carry = (old_size >= other_size)
+            ? biginteger_kernels::add(data, data, old_size, other_data, other_size)
+            : biginteger_kernels::add(data, other_data, other_size, data, old_size);
+        if (carry != 0) {
+            //Лишний лимб нужен только при переносе из старшего разряда
+            resize(max_size + 1);
+            limbs()[max_size] = carry;
         }
-        if (position >= str.size()) {
-            throw std::invalid_argument("There is not enough information in the line");
+    }
+    else {
+        bool other_is_greater = (old_size != other_size) ? old_size < other_size
+            : biginteger_kernels::cmp(limbs(), other_data, old_size) < 0;
+        if (!other_is_greater) {
+            // |this| >= |other|
+            limb_t* data = limbs();
+            biginteger_kernels::sub(data, data, old_size, other_data, other_size);
         }
-        data = new uint32_t[1]{ 0 };
-        size = 1;
-        for (char c : str) {
-            if (isdigit(c) == 0) {
-                throw std::invalid_argument("Invalid decimal digit");
-            }
-            uint32_t digit = c - '0';
-            uint64_t carry = digit;
-            // Умножение на 10 и добавление цифры
-            for (size_t i = 0; i < size; ++i) {
-                uint64_t temp = (uint64_t)data[i] * 10 + carry;
-                data[i] = static_cast<uint32_t>(temp);
-                carry = temp >> 32;
-            }
-            // Обработка переноса
-            while (carry > 0) {
-                resize(size + 1);
-                data[size - 1] = static_cast<uint32_t>(carry);
-                carry >>= 32;
-            }
+        else {
+            // |this| < |other|: результат получает знак other
+            resize(other_size);
+            limb_t* data = limbs();
+            biginteger_kernels::sub(data, other_data, other_size, data, old_size);
+            is_negative = other_negative;
         }
     }
-    catch (std::invalid_argument error_message) {
-        delete[] data;
-        throw std::invalid_argument(error_message.what());
+    //Уберем ведущие нули
+    const limb_t* data = limbs();
+    size = biginteger_kernels::normalized_size(data, size);
+    //Дополнительная проверка на 0
+    if (size == 1 && data[0] == 0) {
+        is_negative = false;
     }
 }
 
-void BigInteger::create_from_hex_string(const std::string& str) {
-    if (str.empty()) {
-        data = new uint32_t[1]{ 0 };
-        size = 1;
+void BigInteger::add_small(uint64_t magnitude, bool negative) {
+    //Частый случай счётчиков: младший лимб меняется без переноса и смены знака
+    limb_t* data = limbs();
+    if (is_negative == negative && data[0] <= ~magnitude) {
+        data[0] += magnitude;
         return;
     }
-    try {
-        size_t position = 0;
-        while (str[position] == '0' && position < str.size()) {
-            ++position;
-        }
-        if (position >= str.size()) {
-            throw std::invalid_argument("There is not enough information in the line");
-        }
-        data = new uint32_t[1]{ 0 };
-        size = 1;
-        for (char c : str) {
-            uint32_t digit;
-            if (isdigit(c) != 0) {
-                digit = c - '0';
-            }
-            else if (c >= 'A' && c <= 'F') {
-                digit = 10 + (c - 'A');
-            }
-            else if (c >= 'a' && c <= 'f') {
-                digit = 10 + (c - 'a');
-            }
-            else {
-                throw std::invalid_argument("Invalid hex digit");
-            }
-            // Умножение текущего значения на 16
-            uint64_t carry = digit;
-            for (size_t i = 0; i < size; ++i) {
-                uint64_t temp = (uint64_t)data[i] * 16 + carry;
-                data[i] = static_cast<uint32_t>(temp);
-                carry = temp >> 32;
-            }
-            // Обработка переноса
-            while (carry > 0) {
-                resize(size + 1);
-                data[size - 1] = static_cast<uint32_t>(carry);
-                carry >>= 32;
-            }
-        }
-    }
-    catch (std::invalid_argument error_message) {
-        delete[] data;
-        throw std::invalid_argument(error_message.what());
+    if (is_negative != negative && data[0] > magnitude) {
+        data[0] -= magnitude;
+        return;
     }
+    add_signed(&magnitude, 1, negative);
 }
-bool BigInteger::isAbsLess(const BigInteger& left, const BigInteger& right) {
-    if (left.get_size() != right.get_size()) {
-        return left.get_size() < right.get_size();
-    }
-    for (size_t i = left.get_size() - 1; i >= 0; --i) {
-        if (left.get_data()[i] != right.get_data()[i]) {
-            return left.get_data()[i] < right.get_data()[i];
-        }
+
+void BigInteger::multiply_small(uint64_t magnitude, bool negative) {
+    const bool result_negative = (is_negative != negative);
+    const limb_t carry = biginteger_kernels::mul_1(limbs(), limbs(), size, magnitude);
+    //Буфер растёт только при переносе, и через resize - в полтора раза
+    if (carry != 0) {
+        resize(size + 1);
+        limbs()[size - 1] = carry;
     }
-    return false;
-}
-
-void BigInteger::absolute_difference(uint32_t*& data, size_t& size,
-    const uint32_t* other_data, size_t other_size) {
-    // data всегда больше other_data
-    //Используем знаковые типы данных (может быть ситуация loc_difference = -1 < 0)
-    int64_t borrow = 0;
-    int64_t loc_difference = 0;
-    size_t max_size = std::max(size, other_size);
-    for (size_t i = 0; i < max_size; ++i) {
-        int64_t a = (i < size) ? data[i] : 0;
-        int64_t b = (i < other_size) ? other_data[i] : 0;
-        //Учитываем занятый бит
-        loc_difference = a - borrow;
-        if (loc_difference >= b) {
-            loc_difference -= b;
-            borrow = 0;
-        }
-        else {
-            //Добавляем 1 ... (32 нуля)
-            loc_difference += (1ULL << 32);
-            loc_difference -= b;
-            borrow = 1;
-        }
-        data[i] = static_cast<uint32_t>(loc_difference);
+    size = biginteger_kernels::normalized_size(limbs(), size);
+    is_negative = result_negative && !isZero();
+}
+
+void BigInteger::divide_small(uint64_t magnitude, bool negative) {
+    if (magnitude == 0) {
+        throw std::invalid_argument("Division by zero");
     }
-    //Удаляем ведущие нули
-    while (size > 1 && data[size - 1] == 0) {
-        --size;
+    limb_t* data = limbs();
+    biginteger_kernels::divrem_1(data, data, size, magnitude);
+    size = biginteger_kernels::normalized_size(data, size);
+    is_negative = (is_negative != negative) && !isZero();
+}
+
+uint64_t BigInteger::remainder_small(uint64_t magnitude) const {
+    if (magnitude == 0) {
+        throw std::invalid_argument("Modulo by zero");
     }
-    if (borrow != 0) {
-        throw std::logic_error("data < other_data");
+    return biginteger_kernels::mod_1(limbs(), size, magnitude);
+}
+
+int BigInteger::compare_small(uint64_t magnitude, bool negative) const {
+    //Знак и длина решают сравнение без прохода по лимбам
+    negative = negative && magnitude != 0;
+    if (is_negative != negative) {
+        return is_negative ? -1 : 1;
     }
+    int magnitude_order = (size > 1) ? 1 : (limbs()[0] > magnitude) - (limbs()[0] < magnitude);
+    return is_negative ? -magnitude_order : magnitude_order;
 }
 
 //-------------------------------------К О Н С Т Р У К Т О Р Ы------------------------------------------------------------------------
 
-BigInteger::BigInteger() : data(new uint32_t[1]{ 0 }), size(1), is_negative(false) {}
-
-BigInteger::BigInteger(int num)
-    : data(new uint32_t[1]{ static_cast<uint32_t>((num > 0) ? num : -num) }),
-    size(1),
-    is_negative(num < 0) {}
-
-BigInteger::BigInteger(unsigned int num)
-    : data(new uint32_t[1]{ static_cast<uint32_t>(num) }),
-    size(1),
-    is_negative(false) {}
-
-BigInteger::BigInteger(long num) {
-    is_negative = (num < 0);
-    uint64_t abs_num = static_cast<uint64_t>(is_negative ? -num : num);
-    // Всегда создаем массив из 2 элементов
-    data = new uint32_t[2]{
-        static_cast<uint32_t>(abs_num),          // Младшие 32 бита
-        static_cast<uint32_t>(abs_num >> 32)     // Старшие 32 бита
-    };
-    size = 2;
-    // Автоматическое удаление ведущих нулей
-    if (data[1] == 0) {
-        size = 1;
-        uint32_t* new_data = new uint32_t[1]{ data[0] };
-        delete[] data;
-        data = new_data;
-    }
-}
-
-BigInteger::BigInteger(long long num) {
-    is_negative = (num < 0);
-    uint64_t abs_num = static_cast<uint64_t>(is_negative ? -num : num);
-    // Всегда создаем массив из 2 элементов
-    data = new uint32_t[2]{
-        static_cast<uint32_t>(abs_num),
-        static_cast<uint32_t>(abs_num >> 32)
-    };
-    size = 2;
-    // Автоматическое удаление ведущих нулей
-    if (data[1] == 0) {
-        size = 1;
-        uint32_t* new_data = new uint32_t[1]{ data[0] };
-        delete[] data;
-        data = new_data;
-    }
+BigInteger::BigInteger() {}
+
+BigInteger::BigInteger(int num) : is_negative(num < 0) {
+    local[0] = static_cast<limb_t>((num > 0) ? num : -static_cast<long long>(num));
+}
+
+BigInteger::BigInteger(unsigned int num) {
+    local[0] = num;
+}
+
+BigInteger::BigInteger(long num) : is_negative(num < 0) {
+    assign_magnitude(is_negative ? 0ULL - static_cast<uint64_t>(num) : static_cast<uint64_t>(num));
+}
+
+BigInteger::BigInteger(long long num) : is_negative(num < 0) {
+    assign_magnitude(is_negative ? 0ULL - static_cast<uint64_t>(num) : static_cast<uint64_t>(num));
 }
 
-BigInteger::BigInteger(unsigned long num) : is_negative(false) {
-    uint64_t abs_num = static_cast<uint64_t>(num);
-    data = new uint32_t[2]{
-        static_cast<uint32_t>(abs_num),
-        static_cast<uint32_t>(abs_num >> 32)
-    };
-    size = (data[1] == 0) ? 1 : 2; // Удаление ведущих нулей
+BigInteger::BigInteger(unsigned long num) {
+    assign_magnitude(num);
 }
 
-BigInteger::BigInteger(unsigned long long num) : is_negative(false) {
-    uint64_t abs_num = static_cast<uint64_t>(num);
-    data = new uint32_t[2]{
-        static_cast<uint32_t>(abs_num),
-        static_cast<uint32_t>(abs_num >> 32)
-    };
-    size = (data[1] == 0) ? 1 : 2; // Удаление ведущих нулей
+BigInteger::BigInteger(unsigned long long num) {
+    assign_magnitude(num);
 }
 
 BigInteger::BigInteger(const BigInteger& other) : is_negative(other.is_negative) {
-    data = new uint32_t[other.size];
-    for (size_t i = 0; i < other.size; ++i) {
-        data[i] = other.data[i];
-    }
-    size = other.size;
+    resize(other.size);
+    std::copy(other.limbs(), other.limbs() + other.size, limbs());
 }
 
-BigInteger::BigInteger(BigInteger&& other) noexcept : data(other.data), size(other.size) {
-    other.data = nullptr;
-    other.size = 0;
+BigInteger::BigInteger(BigInteger&& other) noexcept
+    : size(other.size), capacity(other.capacity), is_negative(other.is_negative), resource(other.resource) {
+    //Встроенные лимбы копируются, буфер в куче забирается; other остаётся нулём
+    if (other.is_inline()) {
+        std::copy(other.local, other.local + INLINE_LIMBS, local);
+    }
+    else {
+        heap = other.heap;
+        other.capacity = INLINE_LIMBS;
+    }
+    other.local[0] = 0;
+    other.size = 1;
+    other.is_negative = false;
 }
 
 BigInteger::BigInteger(std::string str, biginteger_base base) {
@@ -259,8 +204,6 @@ BigInteger::BigInteger(std::string str, biginteger_base base) {
     str.erase(0, i);
     if (str.empty()) {
         if (isZero) {
-            data = new uint32_t[1]{ 0 };
-            size = 1;
             is_negative = false;
             return;
         }
@@ -273,7 +216,15 @@ BigInteger::BigInteger(std::string str, biginteger_base base) {
         break;
     }
     case biginteger_base::hex: {
-        create_from_hex_string(str);
+        create_from_power_of_two_string(str.data(), str.data() + str.size(), 4);
+        break;
+    }
+    case biginteger_base::oct: {
+        create_from_power_of_two_string(str.data(), str.data() + str.size(), 3);
+        break;
+    }
+    case biginteger_base::bin: {
+        create_from_power_of_two_string(str.data(), str.data() + str.size(), 1);
         break;
     }
     default: {
@@ -282,73 +233,98 @@ BigInteger::BigInteger(std::string str, biginteger_base base) {
     }
 }
 
+BigInteger::BigInteger(std::pmr::memory_resource* resource)
+    : resource(resource != nullptr ? resource : limb_pool()) {}
+
 BigInteger::~BigInteger() {
-    delete[] data;
+    if (!is_inline()) {
+        deallocate_limbs(heap, capacity);
+    }
 }
 
 //------------------------------------------------О П Е Р А Т О Р Ы----------------------------------------------------------------------
 //Оператор копирования
 BigInteger& BigInteger::operator=(const BigInteger& other) {
     if (this != &other) {
-        delete[] data;
-        data = new uint32_t[other.size];
-        for (int i = 0; i < other.size; ++i) {
-            data[i] = other.data[i];
-        }
-        size = other.size;
+        //Уже выделенная память переиспользуется, если её хватает
+        resize(other.size);
+        std::copy(other.limbs(), other.limbs() + other.size, limbs());
         is_negative = other.is_negative;
     }
     return *this;
 }
 
 //Оператор перемещения
-BigInteger& BigInteger::operator=(BigInteger&& other) noexcept {
-    if (*this != other) {
-        delete[] data;
-        data = other.data;
-        size = other.size;
-        is_negative = other.is_negative;
-        other.size = 0;
-        other.data = nullptr;
+BigInteger& BigInteger::operator=(BigInteger&& other) {
+    if (this == &other) {
+        return *this;
+    }
+    if (!other.is_inline() && *resource != *other.resource) {
+        //Чужой буфер освобождался бы не тем источником: лимбы копируются
+        *this = other;
+        return *this;
+    }
+    if (!is_inline()) {
+        deallocate_limbs(heap, capacity);
     }
+    size = other.size;
+    capacity = other.capacity;
+    is_negative = other.is_negative;
+    if (other.is_inline()) {
+        std::copy(other.local, other.local + INLINE_LIMBS, local);
+    }
+    else {
+        heap = other.heap;
+        other.capacity = INLINE_LIMBS;
+    }
+    other.local[0] = 0;
+    other.size = 1;
+    other.is_negative = false;
     return *this;
 }
 
 //Унарные операторы
-BigInteger BigInteger::operator-() const {
+BigInteger BigInteger::operator-() const& {
     BigInteger result(*this);
-    if (*this != BigInteger(0)) {
-        result.set_is_negative(!is_negative);
-    }
+    result.is_negative = !is_negative && !isZero();
     return result;
 }
 
+BigInteger BigInteger::operator-() && {
+    is_negative = !is_negative && !isZero();
+    return std::move(*this);
+}
+
 BigInteger BigInteger::operator+() const {
     return *this;
 }
 
 
-//Операторы сравнения
-bool BigInteger::operator!=(const BigInteger& other) const {
-    return !(*this == other);
-}
-bool BigInteger::operator<(const BigInteger& other) const {
-    return isLess(*this, other);
-}
-bool BigInteger::operator<=(const BigInteger& other) const {
-    return isLess(*this, other) || (*this == other);
-}
-bool BigInteger::operator>(const BigInteger& other) const {
-    return isLess(other, *this);
-}
-bool BigInteger::operator>=(const BigInteger& other) const {
-    return !isLess(*this, other);
+//Оператор сравнения
+std::strong_ordering BigInteger::operator<=>(const BigInteger& other) const {
+    if (is_negative != other.is_negative) {
+        return is_negative ? std::strong_ordering::less : std::strong_ordering::greater;
+    }
+    //У отрицательных чисел порядок модулей обратный
+    const BigInteger& left = is_negative ? other : *this;
+    const BigInteger& right = is_negative ? *this : other;
+    if (left.size != right.size) {
+        return left.size <=> right.size;
+    }
+    //Случайные числа почти всегда различаются уже в старшем лимбе: он сравнивается без вызова ядра
+    const limb_t* a = left.limbs();
+    const limb_t* b = right.limbs();
+    const size_t top = left.size - 1;
+    if (a[top] != b[top]) {
+        return a[top] <=> b[top];
+    }
+    return biginteger_kernels::cmp(a, b, top) <=> 0;
 }
 
 
 //Инкремент и декремент
 BigInteger& BigInteger::operator++() { //Префиксный 
-    *this += BigInteger(1);
+    add_small(1, false);
     return *this;
 }
 BigInteger BigInteger::operator++(int) { //Постфиксный
@@ -357,7 +333,7 @@ BigInteger BigInteger::operator++(int) { //Постфиксный
     return temp;
 }
 BigInteger& BigInteger::operator--() { //Префиксный 
-    *this -= BigInteger(1);
+    add_small(1, true);
     return *this;
 }
 BigInteger BigInteger::operator--(int) { //Постфиксный
@@ -369,176 +345,116 @@ BigInteger BigInteger::operator--(int) { //Постфиксный
 
 //Арифмитические операторы
 BigInteger& BigInteger::operator+=(const BigInteger& other) {
-    if (is_negative == other.is_negative) {  //Новые данные для суммы
-        size_t max_size = std::max(size, other.get_size());
-        uint32_t* new_data = new uint32_t[max_size + 1]();
-        uint64_t carry = 0;
-        uint64_t sum = 0;
-        size_t i;
-        for (i = 0; i < max_size; ++i) {
-            //Выбираем 0, ечли число закончилось
-            uint64_t a = (i < size) ? data[i] : 0;
-            uint64_t b = (i < other.get_size()) ? other.get_data()[i] : 0;
-            //Находим сумму с учетом переноса
-            sum = a + b + carry;
-            //Записываем в итоговый массив суженное значение суммы
-            new_data[i] = static_cast<uint32_t>(sum);
-            //Перенос в старшие биты
-            carry = sum >> 32;
-        }
-        if (carry != 0) {
-            new_data[max_size] = static_cast<uint32_t>(carry);
-            size = max_size + 1;
-        }
-        else {
-            size = max_size;
-        }
-        // Удаление ведущих нулей
-        while (size > 1 && new_data[size - 1] == 0) {
-            --size;
-        }
-        delete[] data;
-        data = new_data;
-    }
-    else {
-        BigInteger first = *this;
-        first.set_is_negative(false);
-        BigInteger second = other;
-        second.set_is_negative(false);
-        if (first > second) {
-            // |this| > |other|
-            absolute_difference(data, size, other.get_data(), other.get_size());
-        }
-        else {
-            // |this| <= |other|
-            size_t temp_size = other.get_size();
-            uint32_t* temp = new uint32_t[temp_size];
-            for (size_t i = 0; i < temp_size; ++i) {
-                temp[i] = other.get_data()[i];
-            }
-            //Ищем абсолютную разницу
-            absolute_difference(temp, temp_size, data, size);
-            //Удаляем старые данные 
-            delete[] data;
-            data = temp;
-            size = temp_size;
-            is_negative = other.get_is_negative();
-        }
-        //Уберем ведущие нули
-        while (size > 1 && data[size - 1] == 0) {
-            --size;
-        }
-        //Дополнительная проверка на 0
-        if (size == 1 && data[0] == 0) {
-            is_negative = false;
-        }
-    }
+    //Модули складываются или вычитаются на месте, без копий операндов
+    add_signed(other.limbs(), other.size, other.is_negative);
     return *this;
 }
 
 BigInteger& BigInteger::operator-=(const BigInteger& other) {
-    BigInteger temp = other;
-    temp.set_is_negative(!other.get_is_negative());
-    return *this += temp;
+    add_signed(other.limbs(), other.size, !other.is_negative);
+    return *this;
 }
 
 BigInteger& BigInteger::operator*=(const BigInteger& other) {
     // Обработка знака результата
     bool result_negative = (is_negative != other.is_negative);
-    // Работа с абсолютными значениями
-    const uint32_t* a_data = data;
-    const uint32_t* b_data = other.get_data();
-    size_t a_size = size;
-    size_t b_size = other.get_size();
+    if (other.size == 1) {
+        // Умножение на один лимб выполняется на месте
+        multiply_small(other.limbs()[0], other.is_negative);
+        return *this;
+    }
     /// 999 * 999 < 998 001 < 1 000 000 (любое n значное число * на любое m значное < n + m значное число)
-    size_t result_size = a_size + b_size;
-    uint32_t* result_data = new uint32_t[result_size](); // Инициализация нулями
-    // Умножение в столбик
-    for (size_t i = 0; i < a_size; ++i) {
-        uint64_t carry = 0; // Перенос для текущего разряда
-        for (size_t j = 0; j < b_size; ++j) {
-            // Произведение текущих разрядов + перенос + текущее значение в result
-            uint64_t product = (uint64_t)a_data[i] * b_data[j];
-            uint64_t sum = product + result_data[i + j] + carry;
-            // Обновление текущего разряда
-            result_data[i + j] = static_cast<uint32_t>(sum);
-            // Вычисление нового переноса
-            carry = sum >> 32;
-        }
-        // Добавление оставшегося переноса в старшие разряды
-        if (carry > 0) {
-            result_data[i + b_size] += static_cast<uint32_t>(carry);
-        }
+    // Произведение не может совпадать с множителями; при малых размерах оно во встроенном буфере
+    BigInteger result;
+    result.resize(size + other.size);
+    // Алгоритм выбирается по размерам множителей, больший множитель идёт первым; x *= x возводится в квадрат
+    if (size >= other.size) {
+        multiply_magnitudes(result.limbs(), limbs(), size, other.limbs(), other.size);
+    }
+    else {
+        multiply_magnitudes(result.limbs(), other.limbs(), other.size, limbs(), size);
     }
-    // Обновление данных текущего объекта
-    delete[] data;
-    data = result_data;
-    size = result_size;
-    is_negative = result_negative;
     // Удаление ведущих нулей
-    while (size > 1 && data[size - 1] == 0) {
-        --size;
+    const limb_t* data = result.limbs();
+    while (result.size > 1 && data[result.size - 1] == 0) {
+        --result.size;
     }
     // Обработка нуля
-    if (size == 1 && data[0] == 0) {
-        is_negative = false;
-    }
+    result.is_negative = result_negative && !(result.size == 1 && data[0] == 0);
+    *this = std::move(result);
     return *this;
 }
 
-BigInteger& BigInteger::operator/=(const BigInteger& divisor) {
-    // Обработка знака результата
-    bool result_negative = (is_negative != divisor.is_negative);
-    // Проверка деления на ноль
-    if (divisor.isZero()) {
-        throw std::invalid_argument("Division by zero");
+BigInteger BigInteger::square() const {
+    BigInteger result;
+    result.resize(2 * size);
+    //Одинаковые указатели на множители выбирают в multiply_magnitudes ветку возведения в квадрат
+    multiply_magnitudes(result.limbs(), limbs(), size, limbs(), size);
+    result.size = biginteger_kernels::normalized_size(result.limbs(), 2 * size);
+    return result;
+}
+
+BigInteger& BigInteger::multiply_accumulate(const BigInteger& a, const BigInteger& b, bool subtract) {
+    if (a.isZero() || b.isZero()) {
+        return *this;
     }
-    // Работа с модулями
-    BigInteger dividend = this->abs();
-    BigInteger divisor_abs = divisor.abs();
-    if (dividend < divisor_abs) {
-        *this = BigInteger(0);
-        is_negative = false;
+    const bool product_negative = (a.is_negative != b.is_negative) != subtract;
+    const BigInteger& longer = (a.size >= b.size) ? a : b;
+    const BigInteger& shorter = (a.size >= b.size) ? b : a;
+    const bool aliased = (&longer == this || &shorter == this);
+    if (isZero() && shorter.size == 1) {
+        //Произведение на один лимб: буфер растёт только при переносе из старшего лимба
+        resize(longer.size);
+        std::copy(longer.limbs(), longer.limbs() + longer.size, limbs());
+        is_negative = product_negative;
+        multiply_small(shorter.limbs()[0], false);
         return *this;
     }
-    // Частное и остаток
-    BigInteger quotient = 0;
-    BigInteger remainder = 0;
-    for (long long i = static_cast<long long>(dividend.size) - 1; i >= 0; --i) {
-        // Сдвиг остатка и добавление текущего блока
-        remainder *= BigInteger(0x100000000);
-        remainder += BigInteger(dividend.data[i]);
-        // Бинарный поиск q: divisor_abs * q <= remainder
-        uint32_t q_low = 0;
-        uint32_t q_high = 0xFFFFFFFF;
-        uint32_t q = 0;
-        BigInteger product;
-        while (q_low <= q_high) {
-            uint32_t mid = q_low + (q_high - q_low) / 2;
-            product = divisor_abs;
-            product *= BigInteger(mid); // Используем *=
-            if (product <= remainder) {
-                q = mid;
-                q_low = mid + 1;
-            }
-            else {
-                q_high = mid - 1;
-            }
-        }
-        // Обновление остатка и частного
-        product = divisor_abs;
-        product *= BigInteger(q);
-        remainder -= product;
-        quotient *= BigInteger(0x100000000);
-        quotient += BigInteger(q);
+    if (isZero()) {
+        //Произведение пишется прямо в буфер результата; a и b с одним адресом возводятся в квадрат
+        resize(longer.size + shorter.size);
+        multiply_magnitudes(limbs(), longer.limbs(), longer.size, shorter.limbs(), shorter.size);
+        size = biginteger_kernels::normalized_size(limbs(), size);
+        is_negative = product_negative;
+        return *this;
     }
-    // Удаление ведущих нулей
-    while (quotient.size > 1 && quotient.data[quotient.size - 1] == 0) {
-        quotient.size--;
+    if (shorter.size == 1 && is_negative == product_negative && !aliased) {
+        // |this| += |longer| * limb одним проходом addmul_1
+        const size_t old_size = size;
+        resize(std::max(old_size, longer.size) + 1);
+        limb_t* data = limbs();
+        const limb_t carry = biginteger_kernels::addmul_1(data, longer.limbs(), longer.size, shorter.limbs()[0]);
+        biginteger_kernels::add_to(data + longer.size, size - longer.size, &carry, 1);
+        size = biginteger_kernels::normalized_size(data, size);
+        return *this;
     }
-    // Обновление результата
-    quotient.is_negative = result_negative;
-    *this = quotient;
+    //Небольшое произведение помещается в буфер на стеке, большее - во временный буфер из текущего
+    //источника памяти (по умолчанию его блок возвращается в пул лимбов)
+    constexpr size_t STACK_PRODUCT_LIMBS = 64;
+    const size_t product_size = longer.size + shorter.size;
+    limb_t stack_product[STACK_PRODUCT_LIMBS];
+    std::pmr::vector<limb_t> heap_product(default_memory_resource());
+    limb_t* product = stack_product;
+    if (product_size > STACK_PRODUCT_LIMBS) {
+        heap_product.resize(product_size);
+        product = heap_product.data();
+    }
+    multiply_magnitudes(product, longer.limbs(), longer.size, shorter.limbs(), shorter.size);
+    add_signed(product, biginteger_kernels::normalized_size(product, product_size), product_negative);
+    return *this;
+}
+
+BigInteger& BigInteger::addmul(const BigInteger& a, const BigInteger& b) {
+    return multiply_accumulate(a, b, false);
+}
+
+BigInteger& BigInteger::submul(const BigInteger& a, const BigInteger& b) {
+    return multiply_accumulate(a, b, true);
+}
+
+BigInteger& BigInteger::operator/=(const BigInteger& divisor) {
+    BigInteger remainder;
+    divmod(*this, divisor, *this, remainder);
     return *this;
 }
 
@@ -546,13 +462,8 @@ BigInteger& BigInteger::operator%=(const BigInteger& other) {
     if (other.isZero()) {
         throw std::invalid_argument("Modulo by zero");
     }
-    BigInteger temp = *this;
-    temp /= other;
-    temp *= other;
-    *this -= temp;
-    if (*this == 0) {
-        is_negative = false;
-    }
+    BigInteger quotient;
+    divmod(*this, other, quotient, *this);
     return *this;
 }
 
@@ -562,10 +473,24 @@ bool BigInteger::get_is_negative() const {
     return is_negative;
 }
 size_t BigInteger::get_size() const {
-    return size;
+    //Старший лимб с нулевой верхней половиной даёт на одно 32-битное слово меньше
+    return 2 * size - ((limbs()[size - 1] >> 32) == 0 ? 1 : 0);
+}
+size_t BigInteger::get_capacity() const {
+    return 2 * capacity;
 }
-const uint32_t* BigInteger::get_data() const {
-    return data;
+std::vector<uint32_t> BigInteger::get_data() const {
+    std::vector<uint32_t> words(get_size());
+    get_data(words);
+    return words;
+}
+size_t BigInteger::get_data(std::span<uint32_t> words) const {
+    const size_t count = std::min(words.size(), get_size());
+    const limb_t* data = limbs();
+    for (size_t i = 0; i < count; ++i) {
+        words[i] = static_cast<uint32_t>(data[i / 2] >> (32 * (i % 2)));
+    }
+    return count;
 }
 
 //Сеттер
@@ -580,175 +505,234 @@ BigInteger BigInteger::abs() const {
 }
 
 bool BigInteger::isZero() const {
-    return (*this == 0);
+    return size == 1 && limbs()[0] == 0;
+}
+
+int BigInteger::sign() const {
+    return isZero() ? 0 : (is_negative ? -1 : 1);
 }
 
 int BigInteger::divide_by_10() {
+    limb_t* data = limbs();
     if (size == 1 && data[0] == 0) {
         return 0;
     }
-    uint64_t remainder = 0; //Остаток 64 бита, чтобы учитывать перенос от старшего блока к младшему на 32 бита
-    for (size_t i = size; i-- > 0;) {
-        //data[i] последовательно делится на 10, но с учётом остатка от предыдущего деления
-        uint64_t current = (remainder << 32) + data[i];
-        uint64_t quotient = current / 10; //Значение , которое будет записано в data[i]
-        remainder = current % 10;
-        data[i] = static_cast<uint32_t>(quotient);
-    }
+    //Лимбы делятся от старшего к младшему с переносом остатка, частное пишется на место
+    limb_t remainder = biginteger_kernels::divrem_1(data, data, size, 10);
     size_t new_size = size;
     while (new_size > 0 && data[new_size - 1] == 0) {
         --new_size;
     }
     if (new_size == 0) {
-        delete[] data;
-        data = new uint32_t[1]{ 0 };
         size = 1;
         is_negative = false;
         return static_cast<int>(remainder);
     }
-    if (size != new_size) {
-        uint32_t* new_data = new uint32_t[new_size];
-        for (size_t i = 0; i < new_size; ++i) {
-            new_data[i] = data[i];
-        }
-        delete[] data;
-        data = new_data;
-        size = new_size;
-    }
+    //Память не перевыделяется, уменьшается только длина
+    size = new_size;
     return static_cast<int>(remainder);
 }
 
 int BigInteger::divide_by_16() {
+    limb_t* data = limbs();
     if (size == 1 && data[0] == 0) {
         return 0;
     }
-    uint64_t remainder = 0; //Остаток 64 бита, чтобы учитывать перенос от старшего блока к младшему на 32 бита
-    for (size_t i = size; i-- > 0;) {
-        //data[i] последовательно делится на 10, но с учётом остатка от предыдущего деления
-        uint64_t current = (remainder << 32) + data[i];
-        uint64_t quotient = current / 16; //Значение , которое будет записано в data[i]
-        remainder = current % 16;
-        data[i] = static_cast<uint32_t>(quotient);
-    }
+    //Лимбы делятся от старшего к младшему с переносом остатка, частное пишется на место
+    limb_t remainder = biginteger_kernels::divrem_1(data, data, size, 16);
     size_t new_size = size;
     while (new_size > 0 && data[new_size - 1] == 0) {
         --new_size;
     }
     if (new_size == 0) {
-        delete[] data;
-        data = new uint32_t[1]{ 0 };
         size = 1;
         is_negative = false;
         return static_cast<int>(remainder);
     }
-    if (size != new_size) {
-        uint32_t* new_data = new uint32_t[new_size];
-        for (size_t i = 0; i < new_size; ++i) {
-            new_data[i] = data[i];
-        }
-        delete[] data;
-        data = new_data;
-        size = new_size;
-    }
+    //Память не перевыделяется, уменьшается только длина
+    size = new_size;
     return static_cast<int>(remainder);
 }
 
-bool BigInteger::isLess(const BigInteger& left, const BigInteger& right) {
-    if (left == right) {
-        return false;
-    }
-    if (left.get_is_negative() != right.get_is_negative()) {
-        return left.get_is_negative();
-    }
-    if (left.get_is_negative()) {
-        return !isAbsLess(left, right);
+BigInteger BigInteger::copy_with_room(const BigInteger& value, size_t known_limbs, size_t extra_limbs) {
+    BigInteger result;
+    if (known_limbs > INLINE_LIMBS) {
+        result.reserve_limbs(known_limbs + extra_limbs);
     }
-    return isAbsLess(left, right);
+    result = value;
+    return result;
 }
 
-//-----------------------------------------------------------В Н Е Ш Н И Е----------------------------------------------------------------
+void BigInteger::reserve(size_t new_capacity) {
+    reserve_limbs((new_capacity + 1) / 2);
+}
 
-//Бинарный оператор сравнения
-bool operator==(const BigInteger& left, const BigInteger& right) {
-    if (left.get_is_negative() != right.get_is_negative() || left.get_size() != right.get_size()) {
-        return false;
+void BigInteger::reserve_limbs(size_t new_capacity) {
+    if (new_capacity <= capacity) {
+        return;
     }
-    for (size_t i = 0; i < left.get_size(); ++i) {
-        if (left.get_data()[i] != right.get_data()[i]) {
-            return false;
-        }
+    limb_t* new_data = allocate_limbs(new_capacity);
+    std::copy(limbs(), limbs() + size, new_data);
+    if (!is_inline()) {
+        deallocate_limbs(heap, capacity);
     }
-    return true;
+    heap = new_data;
+    capacity = new_capacity;
 }
 
-//Перевод BigInteger в строку
-std::string to_string(const BigInteger& b_int) {
-    if (b_int.isZero()) {
-        return "0";
-    }
-    BigInteger temp = b_int.abs();
-    std::string result;
-    result.reserve(b_int.get_size() * 10);
-    while (!temp.isZero()) {
-        int digit = (temp.divide_by_10());
-        result += std::to_string(digit);
-    }
-    if (b_int.get_is_negative()) {
-        result += '-';
-    }
-    std::reverse(result.begin(), result.end());
-    return result;
+BigInteger::limb_t* BigInteger::allocate_limbs(size_t count) {
+    return static_cast<limb_t*>(resource->allocate(count * sizeof(limb_t), alignof(limb_t)));
 }
 
-std::string to_hex(const BigInteger& b_int) {
-    if (b_int.isZero()) {
-        return "0";
+void BigInteger::deallocate_limbs(limb_t* data, size_t count) {
+    resource->deallocate(data, count * sizeof(limb_t), alignof(limb_t));
+}
+
+void BigInteger::shrink_to_fit() {
+    if (is_inline() || size == capacity) {
+        return;
     }
-    BigInteger temp = b_int.abs();
-    std::string result;
-    const char alphabet[] = "0123456789ABCDEF";
-    result.reserve(b_int.get_size() * 10);
-    while (!temp.isZero()) {
-        int digit = (temp.divide_by_16());
-        result += alphabet[digit];
+    limb_t* old_data = heap;
+    const size_t old_capacity = capacity;
+    if (size <= INLINE_LIMBS) {
+        std::copy(old_data, old_data + size, local);
+        capacity = INLINE_LIMBS;
     }
-    if (b_int.get_is_negative()) {
-        result += '-';
+    else {
+        heap = allocate_limbs(size);
+        std::copy(old_data, old_data + size, heap);
+        capacity = size;
     }
-    std::reverse(result.begin(), result.end());
-    return result;
+    deallocate_limbs(old_data, old_capacity);
+}
+
+std::pmr::memory_resource* BigInteger::get_memory_resource() const {
+    return resource;
 }
-//Бинарные операторы сравнения
 
+namespace {
+    //Источник памяти новых чисел потока; nullptr - пул лимбов
+    thread_local std::pmr::memory_resource* thread_resource = nullptr;
+}
+
+std::pmr::memory_resource* BigInteger::default_memory_resource() {
+    return thread_resource != nullptr ? thread_resource : limb_pool();
+}
+
+std::pmr::memory_resource* BigInteger::set_default_memory_resource(std::pmr::memory_resource* resource) {
+    std::pmr::memory_resource* previous = default_memory_resource();
+    thread_resource = resource;
+    return previous;
+}
+
+MemoryResourceScope::MemoryResourceScope(std::pmr::memory_resource* resource) : previous(thread_resource) {
+    thread_resource = resource;
+}
+
+MemoryResourceScope::~MemoryResourceScope() {
+    thread_resource = previous;
+}
+
+bool BigInteger::isLess(const BigInteger& left, const BigInteger& right) {
+    return (left <=> right) < 0;
+}
+
+//-----------------------------------------------------------В Н Е Ш Н И Е----------------------------------------------------------------
+
+//Бинарный оператор сравнения
+bool operator==(const BigInteger& left, const BigInteger& right) {
+    if (left.is_negative != right.is_negative || left.size != right.size) {
+        return false;
+    }
+    return std::equal(left.limbs(), left.limbs() + left.size, right.limbs());
+}
 
 //Бинарные арифметические операторы
 BigInteger operator+(const BigInteger& left, const BigInteger& right) {
-    BigInteger result = left;
-    return result += right;
+    //Копия left сразу получает место под перенос, += не перевыделяет память
+    BigInteger result = BigInteger::copy_with_room(left, std::max(left.size, right.size), 1);
+    result += right;
+    return result;
+}
+BigInteger operator+(BigInteger&& left, const BigInteger& right) {
+    left += right;
+    return std::move(left);
+}
+BigInteger operator+(const BigInteger& left, BigInteger&& right) {
+    right += left;
+    return std::move(right);
+}
+//Оба операнда истекают: берётся буфер более длинного, ему скорее хватит места
+BigInteger operator+(BigInteger&& left, BigInteger&& right) {
+    return (left.get_size() >= right.get_size()) ? std::move(left) + right : left + std::move(right);
 }
 BigInteger operator-(const BigInteger& left, const BigInteger& right) {
-    BigInteger result = left;
-    return result -= right;
+    BigInteger result = BigInteger::copy_with_room(left, std::max(left.size, right.size), 1);
+    result -= right;
+    return result;
+}
+BigInteger operator-(BigInteger&& left, const BigInteger& right) {
+    left -= right;
+    return std::move(left);
+}
+BigInteger operator-(const BigInteger& left, BigInteger&& right) {
+    // left - right = -(right - left)
+    right -= left;
+    return -std::move(right);
+}
+BigInteger operator-(BigInteger&& left, BigInteger&& right) {
+    return (left.get_size() >= right.get_size()) ? std::move(left) - right : left - std::move(right);
 }
 BigInteger operator*(const BigInteger& left, const BigInteger& right) {
-    BigInteger result = left;
-    return result *= right;
+    //Произведение собирается сразу в результате, без копии left
+    BigInteger result;
+    result.addmul(left, right);
+    return result;
+}
+BigInteger operator*(BigInteger&& left, const BigInteger& right) {
+    //Умножение на один лимб идёт на месте, иначе произведение заменяет буфер left
+    left *= right;
+    return std::move(left);
+}
+BigInteger operator*(const BigInteger& left, BigInteger&& right) {
+    right *= left;
+    return std::move(right);
+}
+BigInteger operator*(BigInteger&& left, BigInteger&& right) {
+    return (left.get_size() >= right.get_size()) ? std::move(left) * right : left * std::move(right);
+}
+BigInteger mul_add(const BigInteger& a, const BigInteger& b, const BigInteger& c) {
+    BigInteger result;
+    //Произведение занимает не меньше a.size + b.size - 1 лимбов; лимб сверху - под перенос
+    const size_t known_limbs = std::max(a.size + b.size - 1, c.size);
+    if (known_limbs > BigInteger::INLINE_LIMBS) {
+        result.reserve_limbs(known_limbs + 1);
+    }
+    result.addmul(a, b);
+    //Отдельный return result оставляет возможность NRVO; return result += c копировал бы буфер
+    result += c;
+    return result;
 }
 BigInteger operator/(const BigInteger& left, const BigInteger& right) {
-    BigInteger result = left;
-    return result /= right;
+    BigInteger quotient;
+    BigInteger remainder;
+    BigInteger::divmod(left, right, quotient, remainder);
+    return quotient;
+}
+BigInteger operator/(BigInteger&& left, const BigInteger& right) {
+    left /= right;
+    return std::move(left);
 }
 BigInteger operator%(const BigInteger& left, const BigInteger& right) {
     if (right.isZero()) {
         throw std::invalid_argument("Modulo by zero");
     }
-    BigInteger temp = left / right;
-    BigInteger remainder = left - temp * right;
-    if (remainder == 0) {
-        remainder.set_is_negative(false);
-    }
-    else {
-        remainder.set_is_negative(left.get_is_negative());
-    }
+    BigInteger quotient;
+    BigInteger remainder;
+    BigInteger::divmod(left, right, quotient, remainder);
     return remainder;
 }
+BigInteger operator%(BigInteger&& left, const BigInteger& right) {
+    left %= right;
+    return std::move(left);
+}
@@ -0,0 +1,283 @@
+#include "../include/biginteger.hpp"
+#include "kernels.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+using namespace biginteger_kernels;
+
+//---------------------------------------П О Б И Т О В Ы Е   О П Е Р А Ц И И---------------------------------------------------------
+
+namespace {
+
+    //Запись ±magnitude в дополнительном коде длиной n лимбов (n > size)
+    void load_twos_complement(limb_t* target, const limb_t* magnitude, size_t size, bool negative, size_t n) {
+        std::copy(magnitude, magnitude + size, target);
+        std::fill(target + size, target + n, 0);
+        if (negative) {
+            // -m = ~m + 1
+            const limb_t one = 1;
+            com_n(target, target, n);
+            add_to(target, n, &one, 1);
+        }
+    }
+}
+
+void BigInteger::bitwise_assign(const BigInteger& other, bit_operation operation) {
+    if (!is_negative && !other.is_negative) {
+        //Неотрицательные числа обрабатываются без перевода в дополнительный код.
+        //Старшие лимбы более длинного операнда переходят в | и ^ без изменений, в & - обнуляются
+        const size_t common = std::min(size, other.size);
+        const size_t old_size = size;
+        if (operation != bit_operation::conjunction && other.size > size) {
+            resize(other.size);
+            std::copy(other.limbs() + common, other.limbs() + other.size, limbs() + common);
+        }
+        limb_t* data = limbs();
+        switch (operation) {
+        case bit_operation::conjunction:
+            and_n(data, data, other.limbs(), common);
+            size = normalized_size(data, common);
+            return;
+        case bit_operation::disjunction:
+            or_n(data, data, other.limbs(), common);
+            break;
+        case bit_operation::exclusive:
+            xor_n(data, data, other.limbs(), common);
+            break;
+        }
+        size = normalized_size(data, std::max(old_size, other.size));
+        return;
+    }
+    //Лишний старший лимб хранит знак: дальше влево дополнительный код продолжается этим же битом
+    const size_t n = std::max(size, other.size) + 1;
+    std::pmr::vector<limb_t> buffer(2 * n, default_memory_resource());
+    limb_t* x = buffer.data();
+    limb_t* y = x + n;
+    load_twos_complement(x, limbs(), size, is_negative, n);
+    load_twos_complement(y, other.limbs(), other.size, other.is_negative, n);
+    switch (operation) {
+    case bit_operation::conjunction:
+        and_n(x, x, y, n);
+        break;
+    case bit_operation::disjunction:
+        or_n(x, x, y, n);
+        break;
+    case bit_operation::exclusive:
+        xor_n(x, x, y, n);
+        break;
+    }
+    const bool negative = (x[n - 1] >> (LIMB_BITS - 1)) != 0;
+    if (negative) {
+        //Модуль отрицательного результата: ~r + 1
+        const limb_t one = 1;
+        com_n(x, x, n);
+        add_to(x, n, &one, 1);
+    }
+    const size_t result_size = normalized_size(x, n);
+    reserve_limbs(result_size);
+    std::copy(x, x + result_size, limbs());
+    size = result_size;
+    is_negative = negative && !isZero();
+}
+
+BigInteger BigInteger::operator~() const {
+    // ~x = -x - 1
+    BigInteger result = -*this;
+    --result;
+    return result;
+}
+
+BigInteger& BigInteger::operator&=(const BigInteger& other) {
+    bitwise_assign(other, bit_operation::conjunction);
+    return *this;
+}
+
+BigInteger& BigInteger::operator|=(const BigInteger& other) {
+    bitwise_assign(other, bit_operation::disjunction);
+    return *this;
+}
+
+BigInteger& BigInteger::operator^=(const BigInteger& other) {
+    bitwise_assign(other, bit_operation::exclusive);
+    return *this;
+}
+
+BigInteger& BigInteger::operator<<=(size_t bits) {
+    if (isZero() || bits == 0) {
+        return *this;
+    }
+    //Целые лимбы переносятся копированием, остаток сдвига - одним проходом lshift
+    const size_t limb_shift = bits / LIMB_BITS;
+    const unsigned bit_shift = static_cast<unsigned>(bits % LIMB_BITS);
+    const size_t old_size = size;
+    //Лимб под выдвинутые биты нужен, только если они ненулевые: иначе число может остаться встроенным
+    const bool carry = bit_shift != 0 && (limbs()[old_size - 1] >> (LIMB_BITS - bit_shift)) != 0;
+    resize(old_size + limb_shift + (carry ? 1 : 0));
+    limb_t* data = limbs();
+    if (bit_shift != 0) {
+        const limb_t high = lshift(data + limb_shift, data, old_size, bit_shift);
+        if (carry) {
+            data[old_size + limb_shift] = high;
+        }
+    }
+    else {
+        std::copy_backward(data, data + old_size, data + old_size + limb_shift);
+    }
+    std::fill(data, data + limb_shift, 0);
+    size = normalized_size(data, size);
+    return *this;
+}
+
+BigInteger& BigInteger::operator>>=(size_t bits) {
+    if (isZero() || bits == 0) {
+        return *this;
+    }
+    const size_t limb_shift = bits / LIMB_BITS;
+    const unsigned bit_shift = static_cast<unsigned>(bits % LIMB_BITS);
+    limb_t* data = limbs();
+    //У отрицательного числа округление вниз: модуль увеличивается на 1, если были отброшены единицы
+    bool dropped_ones = false;
+    if (is_negative) {
+        const size_t whole = std::min(limb_shift, size);
+        dropped_ones = std::any_of(data, data + whole, [](limb_t limb) { return limb != 0; });
+        if (!dropped_ones && limb_shift < size && bit_shift != 0) {
+            dropped_ones = (data[limb_shift] & ((limb_t(1) << bit_shift) - 1)) != 0;
+        }
+    }
+    const bool negative = is_negative;
+    if (limb_shift >= size) {
+        data[0] = 0;
+        size = 1;
+    }
+    else {
+        const size_t new_size = size - limb_shift;
+        if (bit_shift != 0) {
+            rshift(data, data + limb_shift, new_size, bit_shift);
+        }
+        else {
+            std::copy(data + limb_shift, data + size, data);
+        }
+        size = normalized_size(data, new_size);
+    }
+    is_negative = false;
+    if (negative) {
+        if (dropped_ones) {
+            ++*this;
+        }
+        is_negative = !isZero();
+    }
+    return *this;
+}
+
+size_t BigInteger::bit_length() const {
+    const limb_t* data = limbs();
+    return (size - 1) * LIMB_BITS + static_cast<size_t>(std::bit_width(data[size - 1]));
+}
+
+size_t BigInteger::popcount() const {
+    if (is_negative) {
+        return std::numeric_limits<size_t>::max();
+    }
+    return biginteger_kernels::popcount(limbs(), size);
+}
+
+bool BigInteger::test_bit(size_t index) const {
+    const limb_t* data = limbs();
+    const size_t limb = index / LIMB_BITS;
+    const unsigned offset = static_cast<unsigned>(index % LIMB_BITS);
+    const bool magnitude_bit = limb < size && ((data[limb] >> offset) & 1) != 0;
+    if (!is_negative) {
+        return magnitude_bit;
+    }
+    //Бит -m = ~(m - 1): ниже младшей единицы m - нули, на её месте - единица, выше - инверсия m
+    size_t lowest = 0;
+    while (data[lowest] == 0) {
+        ++lowest;
+    }
+    const size_t lowest_bit = lowest * LIMB_BITS + static_cast<size_t>(std::countr_zero(data[lowest]));
+    if (index < lowest_bit) {
+        return false;
+    }
+    if (index == lowest_bit) {
+        return true;
+    }
+    return !magnitude_bit;
+}
+
+//Бинарные побитовые операторы. Операции коммутативны: копируется тот операнд, длина которого
+//совпадает с длиной результата (короткий для &, длинный для | и ^), и буфер не растёт
+BigInteger operator&(const BigInteger& left, const BigInteger& right) {
+    const bool left_shorter = left.get_size() <= right.get_size();
+    BigInteger result = left_shorter ? left : right;
+    result &= left_shorter ? right : left;
+    return result;
+}
+BigInteger operator&(BigInteger&& left, const BigInteger& right) {
+    left &= right;
+    return std::move(left);
+}
+BigInteger operator&(const BigInteger& left, BigInteger&& right) {
+    right &= left;
+    return std::move(right);
+}
+BigInteger operator&(BigInteger&& left, BigInteger&& right) {
+    return (left.get_size() >= right.get_size()) ? std::move(left) & right : left & std::move(right);
+}
+BigInteger operator|(const BigInteger& left, const BigInteger& right) {
+    const bool left_longer = left.get_size() >= right.get_size();
+    BigInteger result = left_longer ? left : right;
+    result |= left_longer ? right : left;
+    return result;
+}
+BigInteger operator|(BigInteger&& left, const BigInteger& right) {
+    left |= right;
+    return std::move(left);
+}
+BigInteger operator|(const BigInteger& left, BigInteger&& right) {
+    right |= left;
+    return std::move(right);
+}
+BigInteger operator|(BigInteger&& left, BigInteger&& right) {
+    return (left.get_size() >= right.get_size()) ? std::move(left) | right : left | std::move(right);
+}
+BigInteger operator^(const BigInteger& left, const BigInteger& right) {
+    const bool left_longer = left.get_size() >= right.get_size();
+    BigInteger result = left_longer ? left : right;
+    result ^= left_longer ? right : left;
+    return result;
+}
+BigInteger operator^(BigInteger&& left, const BigInteger& right) {
+    left ^= right;
+    return std::move(left);
+}
+BigInteger operator^(const BigInteger& left, BigInteger&& right) {
+    right ^= left;
+    return std::move(right);
+}
+BigInteger operator^(BigInteger&& left, BigInteger&& right) {
+    return (left.get_size() >= right.get_size()) ? std::move(left) ^ right : left ^ std::move(right);
+}
+BigInteger operator<<(const BigInteger& value, size_t bits) {
+    //Память под сдвинутое число выделяется один раз: копия value сразу получает запас на bits
+    BigInteger result = BigInteger::copy_with_room(value, value.size + bits / LIMB_BITS, 1);
+    result <<= bits;
+    return result;
+}
+BigInteger operator<<(BigInteger&& value, size_t bits) {
+    value <<= bits;
+    return std::move(value);
+}
+BigInteger operator>>(const BigInteger& value, size_t bits) {
+    BigInteger result = value;
+    result >>= bits;
+    return result;
+}
+BigInteger operator>>(BigInteger&& value, size_t bits) {
+    value >>= bits;
+    return std::move(value);
+}
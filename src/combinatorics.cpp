@@ -0,0 +1,135 @@
+#include "../include/biginteger.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+//---------------------------------------К О М Б И Н А Т О Р И К А---------------------------------------------------------
+
+namespace {
+
+    //Решето Эратосфена по нечётным числам: простые числа до limit включительно
+    std::vector<uint64_t> primes_up_to(unsigned long limit) {
+        std::vector<uint64_t> primes;
+        if (limit < 2) {
+            return primes;
+        }
+        primes.push_back(2);
+        // composite[i] соответствует числу 2i + 1
+        std::vector<bool> composite(limit / 2 + 1, false);
+        for (uint64_t i = 1; 2 * i + 1 <= limit; ++i) {
+            if (composite[i]) {
+                continue;
+            }
+            const uint64_t p = 2 * i + 1;
+            primes.push_back(p);
+            for (uint64_t multiple = p * p; multiple <= limit; multiple += 2 * p) {
+                composite[multiple / 2] = true;
+            }
+        }
+        return primes;
+    }
+
+    //Произведение factors[first, last) сбалансированным деревом: множители одного уровня близки по длине,
+    //поэтому работают Карацуба, Тоом и NTT
+    BigInteger product_tree(const std::vector<uint64_t>& factors, size_t first, size_t last) {
+        if (last - first <= 8) {
+            BigInteger result = 1;
+            for (size_t i = first; i < last; ++i) {
+                result *= BigInteger(static_cast<unsigned long long>(factors[i]));
+            }
+            return result;
+        }
+        const size_t middle = first + (last - first) / 2;
+        BigInteger result = product_tree(factors, first, middle);
+        result *= product_tree(factors, middle, last);
+        return result;
+    }
+
+    //Произведение множителей: сначала они упаковываются в лимбы, затем перемножаются деревом
+    BigInteger product(const std::vector<uint64_t>& factors) {
+        std::vector<uint64_t> packed;
+        uint64_t accumulator = 1;
+        for (uint64_t factor : factors) {
+            if (accumulator > std::numeric_limits<uint64_t>::max() / factor) {
+                packed.push_back(accumulator);
+                accumulator = 1;
+            }
+            accumulator *= factor;
+        }
+        packed.push_back(accumulator);
+        return product_tree(packed, 0, packed.size());
+    }
+
+    //Нечётная часть простого качания n≀ = n! / (floor(n/2)!)^2 (Люшни): показатель простого p
+    //равен числу нечётных floor(n / p^i)
+    void collect_odd_swing(unsigned long n, const std::vector<uint64_t>& primes, std::vector<uint64_t>& factors) {
+        factors.clear();
+        for (size_t i = 1; i < primes.size() && primes[i] <= n; ++i) {
+            const uint64_t p = primes[i];
+            for (uint64_t q = n / p; q > 0; q /= p) {
+                if ((q & 1) != 0) {
+                    factors.push_back(p);
+                }
+            }
+        }
+    }
+
+    //Нечётная часть n!: odd(n) = odd(n/2)^2 * odd_swing(n)
+    BigInteger odd_factorial(unsigned long n, const std::vector<uint64_t>& primes, std::vector<uint64_t>& factors) {
+        if (n < 21) {
+            uint64_t value = 1;
+            for (uint64_t i = 2; i <= n; ++i) {
+                value *= i;
+            }
+            return BigInteger(static_cast<unsigned long long>(value >> std::countr_zero(value)));
+        }
+        BigInteger result = odd_factorial(n / 2, primes, factors).square();
+        collect_odd_swing(n, primes, factors);
+        result *= product(factors);
+        return result;
+    }
+}
+
+BigInteger factorial(unsigned long n) {
+    const std::vector<uint64_t> primes = primes_up_to(n);
+    std::vector<uint64_t> factors;
+    // n! = odd(n) * 2^(n - popcount(n))
+    BigInteger result = odd_factorial(n, primes, factors);
+    result <<= n - static_cast<unsigned long>(std::popcount(n));
+    return result;
+}
+
+BigInteger binomial(unsigned long n, unsigned long k) {
+    if (k > n) {
+        return BigInteger(0);
+    }
+    k = std::min(k, n - k);
+    //Показатель p в C(n, k) - число переносов при сложении k и n - k в системе с основанием p (Куммер)
+    const std::vector<uint64_t> primes = primes_up_to(n);
+    std::vector<uint64_t> factors;
+    for (uint64_t p : primes) {
+        if (p > n - k && p <= n) {
+            //Простые из (n - k, n] входят ровно один раз
+            factors.push_back(p);
+            continue;
+        }
+        unsigned long top = n;
+        unsigned long low = k;
+        unsigned long rest = n - k;
+        while (top > 0) {
+            if (top / p != low / p + rest / p) {
+                factors.push_back(p);
+            }
+            top /= p;
+            low /= p;
+            rest /= p;
+        }
+    }
+    return product(factors);
+}
+
+BigInteger primorial(unsigned long n) {
+    return product(primes_up_to(n));
+}
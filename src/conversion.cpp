@@ -0,0 +1,389 @@
+#include "../include/biginteger.hpp"
+#include "kernels.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace biginteger_kernels;
+
+//---------------------------------------П Е Р Е В О Д   М Е Ж Д У   С И С Т Е М А М И   С Ч И С Л Е Н И Я---------------------------
+
+namespace {
+
+    //Значение символа как цифры (0-9, a-z и A-Z -> 10-35), для остальных символов - NOT_A_DIGIT
+    constexpr uint8_t NOT_A_DIGIT = 0xFF;
+
+    constexpr std::array<uint8_t, 256> make_digit_table() {
+        std::array<uint8_t, 256> table{};
+        table.fill(NOT_A_DIGIT);
+        for (int i = 0; i < 10; ++i) {
+            table['0' + i] = static_cast<uint8_t>(i);
+        }
+        for (int i = 0; i < 26; ++i) {
+            table['a' + i] = static_cast<uint8_t>(10 + i);
+            table['A' + i] = static_cast<uint8_t>(10 + i);
+        }
+        return table;
+    }
+    constexpr std::array<uint8_t, 256> DIGIT_VALUES = make_digit_table();
+
+    uint32_t digit_value(char c) {
+        return DIGIT_VALUES[static_cast<unsigned char>(c)];
+    }
+
+    constexpr char UPPER_DIGITS[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    constexpr char LOWER_DIGITS[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+    //Блок - наибольшая степень основания, помещающаяся в лимб (для 10 - это 10^19)
+    struct radix_chunk {
+        limb_t value;
+        size_t digits;
+    };
+
+    radix_chunk chunk_of(uint32_t base) {
+        limb_t value = base;
+        size_t digits = 1;
+        while (value <= ~limb_t(0) / base) {
+            value *= base;
+            ++digits;
+        }
+        return { value, digits };
+    }
+
+    //Значение блока цифр, уже проверенных по таблице
+    limb_t parse_chunk(const char* first, const char* last, uint32_t base) {
+        limb_t value = 0;
+        for (; first != last; ++first) {
+            value = value * base + digit_value(*first);
+        }
+        return value;
+    }
+
+    //Цифры |value| в системе с основанием 2^bits вырезаются из лимбов напрямую, без деления:
+    //ровно width младших цифр записываются справа налево, начиная с last
+    void write_power_of_two(const limb_t* data, size_t size, char* last, size_t width, unsigned bits,
+        const char* alphabet) {
+        const limb_t mask = (limb_t(1) << bits) - 1;
+        for (size_t k = 0; k < width; ++k) {
+            const size_t position = k * bits;
+            const size_t limb = position / LIMB_BITS;
+            const unsigned offset = static_cast<unsigned>(position % LIMB_BITS);
+            limb_t digit = (limb < size) ? data[limb] >> offset : 0;
+            //Цифра на стыке двух лимбов (восьмеричная система)
+            if (offset + bits > LIMB_BITS && limb + 1 < size) {
+                digit |= data[limb + 1] << (LIMB_BITS - offset);
+            }
+            *--last = alphabet[digit & mask];
+        }
+    }
+
+    void check_base(int base) {
+        if (base < 2 || base > 36) {
+            throw std::invalid_argument("Unsupported base");
+        }
+    }
+}
+
+const BigInteger& BigInteger::power_of_radix(uint32_t base, size_t level) {
+    //std::vector<BigInteger> не годится: рост вектора делал бы недействительными выданные ссылки
+    thread_local std::vector<std::unique_ptr<BigInteger>> powers[37];
+    std::vector<std::unique_ptr<BigInteger>>& cache = powers[base];
+    //Кэш живёт дольше любого источника памяти, заданного вызывающим: степени берут память по умолчанию
+    const MemoryResourceScope cache_scope(nullptr);
+    while (cache.size() <= level) {
+        if (cache.empty()) {
+            cache.push_back(std::make_unique<BigInteger>(chunk_of(base).value));
+        }
+        else {
+            const BigInteger& previous = *cache.back();
+            cache.push_back(std::make_unique<BigInteger>(previous * previous));
+        }
+    }
+    return *cache[level];
+}
+
+BigInteger BigInteger::from_radix_chunks(const limb_t* chunks, size_t count, uint32_t base) {
+    if (count <= std::max<size_t>(thresholds().radix_conversion, 1)) {
+        //Схема Горнера: умножение на блок и добавление очередного блока; блок < B, блоков не больше лимбов
+        const limb_t chunk = chunk_of(base).value;
+        BigInteger result;
+        result.resize(count);
+        limb_t* data = result.limbs();
+        data[0] = chunks[count - 1];
+        size_t used = 1;
+        for (size_t i = count - 1; i-- > 0;) {
+            limb_t high = mul_1(data, data, used, chunk);
+            if (high != 0) {
+                data[used++] = high;
+            }
+            if (add_to(data, used, &chunks[i], 1) != 0) {
+                data[used++] = 1;
+            }
+        }
+        result.size = normalized_size(data, used);
+        return result;
+    }
+    // value = high * chunk^half + low, half - наибольшая степень двойки, меньшая count
+    size_t level = 0;
+    while ((size_t(2) << level) < count) {
+        ++level;
+    }
+    const size_t half = size_t(1) << level;
+    BigInteger result = from_radix_chunks(chunks + half, count - half, base);
+    result *= power_of_radix(base, level);
+    result += from_radix_chunks(chunks, half, base);
+    return result;
+}
+
+void BigInteger::assign_digits(const char* first, const char* last, uint32_t base) {
+    is_negative = false;
+    //size = 0: resize обнуляет весь буфер, сохраняя его ёмкость
+    size = 0;
+    if (first == last) {
+        resize(1);
+        return;
+    }
+    if (std::has_single_bit(base)) {
+        create_from_power_of_two_string(first, last, static_cast<unsigned>(std::countr_zero(base)));
+        return;
+    }
+    const radix_chunk chunk = chunk_of(base);
+    const size_t count = (static_cast<size_t>(last - first) + chunk.digits - 1) / chunk.digits;
+    if (count <= std::max<size_t>(thresholds().radix_conversion, 1)) {
+        //Схема Горнера по блокам строки от старшего к младшему; старший блок может быть неполным
+        resize(count);
+        limb_t* data = limbs();
+        const char* end = last - (count - 1) * chunk.digits;
+        data[0] = parse_chunk(first, end, base);
+        size_t used = 1;
+        for (size_t i = 1; i < count; ++i, end += chunk.digits) {
+            const limb_t block = parse_chunk(end, end + chunk.digits, base);
+            const limb_t high = mul_1(data, data, used, chunk.value);
+            if (high != 0) {
+                data[used++] = high;
+            }
+            if (add_to(data, used, &block, 1) != 0) {
+                data[used++] = 1;
+            }
+        }
+        size = normalized_size(data, used);
+        return;
+    }
+    //Блоки цифр с конца строки: младший блок первый
+    std::pmr::vector<limb_t> chunks(count, default_memory_resource());
+    const char* end = last;
+    for (size_t i = 0; i < count; ++i) {
+        const char* begin = (i + 1 < count) ? end - chunk.digits : first;
+        chunks[i] = parse_chunk(begin, end, base);
+        end = begin;
+    }
+    resize(1);
+    *this = from_radix_chunks(chunks.data(), count, base);
+}
+
+void BigInteger::create_from_dec_string(const std::string& str) {
+    if (str.empty()) {
+        return;
+    }
+    for (char c : str) {
+        if (digit_value(c) >= 10) {
+            throw std::invalid_argument("Invalid decimal digit");
+        }
+    }
+    const bool negative = is_negative;
+    assign_digits(str.data(), str.data() + str.size(), 10);
+    is_negative = negative && !isZero();
+}
+
+void BigInteger::create_from_power_of_two_string(const char* first, const char* last, unsigned bits_per_digit) {
+    if (first == last) {
+        return;
+    }
+    const limb_t radix = limb_t(1) << bits_per_digit;
+    //Цифры раскладываются по битам лимбов начиная с младшей, каждая ровно один раз
+    resize((static_cast<size_t>(last - first) * bits_per_digit + LIMB_BITS - 1) / LIMB_BITS);
+    limb_t* data = limbs();
+    size_t position = 0;
+    for (const char* it = last; it-- != first; position += bits_per_digit) {
+        const limb_t digit = digit_value(*it);
+        if (digit >= radix) {
+            release();
+            switch (bits_per_digit) {
+            case 1:
+                throw std::invalid_argument("Invalid binary digit");
+            case 3:
+                throw std::invalid_argument("Invalid octal digit");
+            default:
+                throw std::invalid_argument("Invalid hex digit");
+            }
+        }
+        const size_t limb = position / LIMB_BITS;
+        const unsigned offset = static_cast<unsigned>(position % LIMB_BITS);
+        data[limb] |= digit << offset;
+        if (offset + bits_per_digit > LIMB_BITS) {
+            data[limb + 1] |= digit >> (LIMB_BITS - offset);
+        }
+    }
+    size = normalized_size(data, size);
+    if (size == 1 && data[0] == 0) {
+        is_negative = false;
+    }
+}
+
+bool BigInteger::write_digits(const BigInteger& value, char* first, size_t width, uint32_t base,
+    const char* alphabet) {
+    if (std::has_single_bit(base)) {
+        const unsigned bits = static_cast<unsigned>(std::countr_zero(base));
+        write_power_of_two(value.limbs(), value.size, first + width, width, bits, alphabet);
+        return value.bit_length() <= width * bits;
+    }
+    const radix_chunk chunk = chunk_of(base);
+    if (value.size <= std::max<size_t>(thresholds().radix_conversion, 2)) {
+        //Последовательное деление на блок: каждый шаг даёт chunk.digits цифр.
+        //Короткие числа копируются в буфер на стеке
+        constexpr size_t STACK_LIMBS = 64;
+        limb_t stack_buffer[STACK_LIMBS];
+        std::pmr::vector<limb_t> heap_buffer(default_memory_resource());
+        limb_t* rest = stack_buffer;
+        if (value.size > STACK_LIMBS) {
+            heap_buffer.resize(value.size);
+            rest = heap_buffer.data();
+        }
+        std::copy(value.limbs(), value.limbs() + value.size, rest);
+        size_t rest_size = value.size;
+        char* last = first + width;
+        bool fits = true;
+        while (last != first && !(rest_size == 1 && rest[0] == 0)) {
+            limb_t digits = divrem_1(rest, rest, rest_size, chunk.value);
+            rest_size = normalized_size(rest, rest_size);
+            //Блок пишется с ведущими нулями; у старшего блока они попадают в оставшуюся ширину
+            for (size_t i = 0; i < chunk.digits && last != first; ++i) {
+                *--last = alphabet[digits % base];
+                digits /= base;
+            }
+            fits = fits && digits == 0;
+        }
+        std::fill(first, last, '0');
+        return fits && rest_size == 1 && rest[0] == 0;
+    }
+    // |value| = high * chunk^(2^level) + low, делитель - около половины длины value.
+    //Знак value не учитывается: при отрицательном value модули частного и остатка те же
+    size_t level = 0;
+    while (power_of_radix(base, level + 1).size * 2 <= value.size) {
+        ++level;
+    }
+    const size_t low_width = chunk.digits << level;
+    BigInteger high;
+    BigInteger low;
+    divmod(value, power_of_radix(base, level), high, low);
+    write_digits(low, first + width - low_width, low_width, base, alphabet);
+    return write_digits(high, first, width - low_width, base, alphabet);
+}
+
+std::to_chars_result BigInteger::write_number(char* first, char* last, const BigInteger& value, int base,
+    const char* alphabet) {
+    check_base(base);
+    const size_t sign = value.is_negative ? 1 : 0;
+    const size_t bound = size_in_base(value, base);
+    const size_t space = static_cast<size_t>(last - first);
+    if (space < sign + bound) {
+        //Оценка превышает точную длину не больше чем на одну цифру. Если в буфер входит на цифру меньше,
+        //число пишется прямо в него, а write_digits сообщает, поместились ли все цифры
+        if (bound == 1 || space + 1 < sign + bound
+            || !write_digits(value, first + sign, bound - 1, static_cast<uint32_t>(base), alphabet)) {
+            return { last, std::errc::value_too_large };
+        }
+        if (sign != 0) {
+            *first = '-';
+        }
+        return { first + sign + bound - 1, std::errc() };
+    }
+    if (sign != 0) {
+        *first++ = '-';
+    }
+    write_digits(value, first, bound, static_cast<uint32_t>(base), alphabet);
+    //Лишние ведущие нули оценки удаляются сдвигом
+    char* digits = std::find_if(first, first + bound - 1, [](char c) { return c != '0'; });
+    return { std::copy(digits, first + bound, first), std::errc() };
+}
+
+size_t size_in_base(const BigInteger& value, int base) {
+    check_base(base);
+    if (value.isZero()) {
+        return 1;
+    }
+    const size_t bits = value.bit_length();
+    const uint32_t radix = static_cast<uint32_t>(base);
+    if (std::has_single_bit(radix)) {
+        const size_t digit_bits = static_cast<size_t>(std::countr_zero(radix));
+        return (bits + digit_bits - 1) / digit_bits;
+    }
+    //|value| < 2^bits, поэтому цифр не больше bits * log_base(2) + 1; запас покрывает погрешность округления
+    const double digits = static_cast<double>(bits) / std::log2(static_cast<double>(base));
+    return static_cast<size_t>(digits * (1 + 1e-12)) + 1;
+}
+
+std::to_chars_result to_chars(char* first, char* last, const BigInteger& value, int base) {
+    return BigInteger::write_number(first, last, value, base, LOWER_DIGITS);
+}
+
+std::from_chars_result from_chars(const char* first, const char* last, BigInteger& value, int base) {
+    check_base(base);
+    const char* digits = first;
+    const bool negative = (digits != last && *digits == '-');
+    if (negative) {
+        ++digits;
+    }
+    const char* end = digits;
+    while (end != last && digit_value(*end) < static_cast<uint32_t>(base)) {
+        ++end;
+    }
+    if (end == digits) {
+        return { first, std::errc::invalid_argument };
+    }
+    value.assign_digits(digits, end, static_cast<uint32_t>(base));
+    value.set_is_negative(negative && !value.isZero());
+    return { end, std::errc() };
+}
+
+//Перевод BigInteger в строку
+std::string to_string(const BigInteger& b_int) {
+    return to_string(b_int, biginteger_base::dec);
+}
+
+std::string to_hex(const BigInteger& b_int) {
+    return to_string(b_int, biginteger_base::hex);
+}
+
+std::string to_string(const BigInteger& b_int, biginteger_base base) {
+    int radix = 10;
+    switch (base) {
+    case biginteger_base::dec:
+        radix = 10;
+        break;
+    case biginteger_base::hex:
+        radix = 16;
+        break;
+    case biginteger_base::oct:
+        radix = 8;
+        break;
+    case biginteger_base::bin:
+        radix = 2;
+        break;
+    default:
+        throw std::invalid_argument("Unsupported base");
+    }
+    //Строка размечается по верхней оценке длины и обрезается после записи
+    std::string result(size_in_base(b_int, radix) + 1, '\0');
+    std::to_chars_result written = BigInteger::write_number(result.data(), result.data() + result.size(), b_int,
+        radix, UPPER_DIGITS);
+    result.resize(static_cast<size_t>(written.ptr - result.data()));
+    return result;
+}
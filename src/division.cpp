@@ -0,0 +1,235 @@
+#include "../include/biginteger.hpp"
+#include "kernels.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <memory_resource>
+#include <stdexcept>
+#include <vector>
+
+using namespace biginteger_kernels;
+
+//---------------------------------------Д Е Л Е Н И Е   М О Д У Л Е Й---------------------------------------------------------------
+
+BigInteger BigInteger::from_limbs(const limb_t* source, size_t count) {
+    BigInteger result;
+    if (count == 0) {
+        return result;
+    }
+    count = normalized_size(source, count);
+    result.resize(count);
+    std::copy(source, source + count, result.limbs());
+    return result;
+}
+
+//value * B^count при count > 0, иначе value / B^(-count) с отбрасыванием младших лимбов
+BigInteger BigInteger::shift_limbs(const BigInteger& value, long long count) {
+    if (count >= 0) {
+        if (value.isZero() || count == 0) {
+            return value;
+        }
+        BigInteger result;
+        result.resize(value.size + static_cast<size_t>(count));
+        std::copy(value.limbs(), value.limbs() + value.size, result.limbs() + count);
+        result.is_negative = value.is_negative;
+        return result;
+    }
+    size_t drop = static_cast<size_t>(-count);
+    if (drop >= value.size) {
+        return BigInteger();
+    }
+    BigInteger result = from_limbs(value.limbs() + drop, value.size - drop);
+    result.is_negative = value.is_negative && !result.isZero();
+    return result;
+}
+
+//Длина блока, на котором рекурсия Бурникеля - Циглера переходит к столбику. Не больше порога включения,
+//чтобы при сниженном пороге рекурсия действительно спускалась
+size_t BigInteger::recursion_block() {
+    const biginteger_thresholds& limits = thresholds();
+    return std::max<size_t>(std::min(limits.burnikel_ziegler, limits.burnikel_ziegler_block), 8);
+}
+
+//Приближение B^(2k) / D_k методом Ньютона, где D_k - старшие k лимбов нормализованного делителя.
+//Погрешность - несколько единиц; каждый шаг удваивает точность и стоит двух умножений
+BigInteger BigInteger::newton_reciprocal(const limb_t* divisor, size_t n, size_t k) {
+    if (k <= 2 * recursion_block()) {
+        //Начальное приближение - точное деление столбиком
+        std::pmr::vector<limb_t> numerator(2 * k + 1, 0, default_memory_resource());
+        numerator[2 * k] = 1;
+        BigInteger quotient;
+        quotient.resize(k + 1);
+        divrem_normalized(quotient.limbs(), numerator.data(), 2 * k + 1, divisor + n - k, k);
+        quotient.size = normalized_size(quotient.limbs(), k + 1);
+        return quotient;
+    }
+    const size_t h = k / 2 + 1;
+    BigInteger y = newton_reciprocal(divisor, n, h);
+    const BigInteger top = from_limbs(divisor + n - k, k);
+    // X = Y * B^(k-h) + Y * (B^(k+h) - D_k * Y) / B^(2h)
+    BigInteger error = shift_limbs(BigInteger(1), static_cast<long long>(k + h)) - top * y;
+    BigInteger correction = shift_limbs(y * error, -static_cast<long long>(2 * h));
+    return shift_limbs(y, static_cast<long long>(k - h)) + correction;
+}
+
+void BigInteger::divide_2n_by_n(limb_t* quotient, limb_t* numerator, const limb_t* divisor, size_t n) {
+    //numerator - 2n лимбов, старшие n меньше делителя; частное n лимбов, остаток в numerator[0, n)
+    if (n % 2 == 1 || n <= recursion_block()) {
+        divrem_normalized(quotient, numerator, 2 * n, divisor, n);
+        return;
+    }
+    const size_t half = n / 2;
+    divide_3n_by_2n(quotient + half, numerator + half, divisor, half);
+    divide_3n_by_2n(quotient, numerator, divisor, half);
+}
+
+void BigInteger::divide_3n_by_2n(limb_t* quotient, limb_t* numerator, const limb_t* divisor, size_t half) {
+    // A = [A1, A2, A3], B = [B1, B2] блоками по half лимбов, A < B * B^half
+    limb_t* a2 = numerator + half;
+    limb_t* a1 = numerator + 2 * half;
+    const limb_t* b1 = divisor + half;
+    int top = 0;
+    if (cmp(a1, b1, half) < 0) {
+        // Q = [A1, A2] / B1, остаток R1 в A2
+        divide_2n_by_n(quotient, a2, b1, half);
+    }
+    else {
+        // A1 == B1: Q = B^half - 1, R1 = [A1, A2] - Q * B1 = A2 + B1
+        std::fill(quotient, quotient + half, ~limb_t(0));
+        top = static_cast<int>(add_n(a2, a2, b1, half));
+    }
+    // [R1, A3] - Q * B2; оценка Q завышена не более чем на 2
+    std::pmr::vector<limb_t> product(2 * half, default_memory_resource());
+    multiply_magnitudes(product.data(), quotient, half, divisor, half);
+    top -= static_cast<int>(sub_n(numerator, numerator, product.data(), 2 * half));
+    while (top < 0) {
+        sub_1(quotient, quotient, half, 1);
+        top += static_cast<int>(add_n(numerator, numerator, divisor, 2 * half));
+    }
+}
+
+void BigInteger::divide_magnitudes(limb_t* quotient, limb_t* remainder, const limb_t* a, size_t a_size,
+    const limb_t* b, size_t b_size) {
+    if (b_size == 1) {
+        remainder[0] = divrem_1(quotient, a, a_size, b[0]);
+        return;
+    }
+    const biginteger_thresholds& limits = thresholds();
+    const size_t quotient_size = a_size - b_size + 1;
+    const size_t smaller = std::min(quotient_size, b_size);
+    const bool newton = smaller >= std::max<size_t>(limits.newton_division, 64);
+    const bool recursive = !newton && smaller >= std::max<size_t>(limits.burnikel_ziegler, 8);
+
+    //Для Бурникеля - Циглера делитель дополняется нулевыми младшими лимбами до длины m * 2^levels,
+    //чтобы рекурсия делила его пополам вплоть до m <= порога
+    size_t padding = 0;
+    if (recursive) {
+        size_t parts = 1;
+        while ((b_size + parts - 1) / parts > recursion_block()) {
+            parts *= 2;
+        }
+        padding = (b_size + parts - 1) / parts * parts - b_size;
+    }
+    const size_t n = b_size + padding;
+    //Делимое дополняется нулевыми старшими лимбами до целого числа блоков делителя
+    size_t blocks = 1;
+    if (recursive || newton) {
+        blocks = (quotient_size + n - 1) / n;
+    }
+    const size_t u_size = (recursive || newton) ? (blocks + 1) * n : a_size + 1;
+
+    //Нормализация: сдвиг, после которого старший бит делителя равен 1
+    const unsigned shift = static_cast<unsigned>(std::countl_zero(b[b_size - 1]));
+    std::pmr::vector<limb_t> buffer(u_size + n + (u_size - n), 0, default_memory_resource());
+    limb_t* numerator = buffer.data();
+    limb_t* divisor = numerator + u_size;
+    limb_t* blocks_quotient = divisor + n;
+    if (shift > 0) {
+        lshift(divisor + padding, b, b_size, shift);
+        numerator[padding + a_size] = lshift(numerator + padding, a, a_size, shift);
+    }
+    else {
+        std::copy(b, b + b_size, divisor + padding);
+        std::copy(a, a + a_size, numerator + padding);
+    }
+
+    if (!recursive && !newton) {
+        divrem_normalized(quotient, numerator, a_size + 1, divisor, b_size);
+    }
+    else {
+        //Деление блоками: окно из 2n лимбов, старшая половина которого - остаток предыдущего шага
+        BigInteger inverse;
+        BigInteger full_divisor;
+        if (newton) {
+            inverse = newton_reciprocal(divisor, n, n);
+            full_divisor = from_limbs(divisor, n);
+        }
+        for (size_t j = blocks; j-- > 0;) {
+            limb_t* window = numerator + j * n;
+            limb_t* block_quotient = blocks_quotient + j * n;
+            if (recursive) {
+                divide_2n_by_n(block_quotient, window, divisor, n);
+                continue;
+            }
+            // Q ~ (A / B^(n-1)) * I / B^(n+1), затем точная коррекция остатка
+            BigInteger window_value = from_limbs(window, 2 * n);
+            BigInteger q = shift_limbs(from_limbs(window + n - 1, n + 1) * inverse,
+                -static_cast<long long>(n + 1));
+            BigInteger r = window_value - q * full_divisor;
+            while (r.is_negative) {
+                r += full_divisor;
+                --q;
+            }
+            while (r >= full_divisor) {
+                r -= full_divisor;
+                ++q;
+            }
+            std::fill(window, window + 2 * n, 0);
+            std::copy(r.limbs(), r.limbs() + r.size, window);
+            std::copy(q.limbs(), q.limbs() + q.size, block_quotient);
+        }
+        std::copy(blocks_quotient, blocks_quotient + quotient_size, quotient);
+    }
+
+    if (shift > 0) {
+        rshift(remainder, numerator + padding, b_size, shift);
+    }
+    else {
+        std::copy(numerator + padding, numerator + padding + b_size, remainder);
+    }
+}
+
+void BigInteger::divmod(const BigInteger& dividend, const BigInteger& divisor,
+    BigInteger& quotient, BigInteger& remainder) {
+    if (divisor.isZero()) {
+        throw std::invalid_argument("Division by zero");
+    }
+    // Частное усекается к нулю, остаток имеет знак делимого
+    bool quotient_negative = (dividend.is_negative != divisor.is_negative);
+    bool remainder_negative = dividend.is_negative;
+    BigInteger q;
+    BigInteger r;
+    if (dividend.size < divisor.size
+        || (dividend.size == divisor.size && cmp(dividend.limbs(), divisor.limbs(), divisor.size) < 0)) {
+        r = dividend;
+    }
+    else {
+        q.resize(dividend.size - divisor.size + 1);
+        r.resize(divisor.size);
+        divide_magnitudes(q.limbs(), r.limbs(), dividend.limbs(), dividend.size, divisor.limbs(), divisor.size);
+        q.is_negative = quotient_negative;
+        r.is_negative = remainder_negative;
+    }
+    // Удаление ведущих нулей и знака у нуля
+    for (BigInteger* value : { &q, &r }) {
+        while (value->size > 1 && value->limbs()[value->size - 1] == 0) {
+            --value->size;
+        }
+        if (value->size == 1 && value->limbs()[0] == 0) {
+            value->is_negative = false;
+        }
+    }
+    // Результаты записываются в конце: quotient или remainder может совпадать с аргументами
+    quotient = std::move(q);
+    remainder = std::move(r);
+}
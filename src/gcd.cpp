@@ -0,0 +1,430 @@
+#include "../include/biginteger.hpp"
+#include "kernels.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+using namespace biginteger_kernels;
+
+//---------------------------------------Н О Д   И   О Б Р А Т Н Ы Е   П О   М О Д У Л Ю---------------------------------------------------------
+
+namespace {
+
+    //Матрица серии шагов Лемера: модули элементов [a b; c d] и чётность числа шагов.
+    //При чётном числе шагов u' = a u - b v, v' = d v - c u, при нечётном - u' = b v - a u, v' = c u - d v
+    struct lehmer_matrix {
+        limb_t a = 1;
+        limb_t b = 0;
+        limb_t c = 0;
+        limb_t d = 1;
+        bool odd = false;
+        size_t steps = 0;
+    };
+
+    //128 бит числа из n лимбов, начиная с бита shift
+    dlimb_t bit_window(const limb_t* a, size_t n, size_t shift) {
+        const size_t limb = shift / LIMB_BITS;
+        const unsigned offset = static_cast<unsigned>(shift % LIMB_BITS);
+        auto at = [a, n](size_t index) -> dlimb_t { return index < n ? a[index] : 0; };
+        dlimb_t result = ((at(limb + 1) << LIMB_BITS) | at(limb)) >> offset;
+        if (offset != 0) {
+            result |= at(limb + 2) << (2 * LIMB_BITS - offset);
+        }
+        return result;
+    }
+
+    //Частное, если оно не меньше 1 (иначе 0); малые частные - без деления 128-битных чисел
+    dlimb_t small_quotient(dlimb_t numerator, dlimb_t denominator) {
+        if (numerator < denominator) {
+            return 0;
+        }
+        if (numerator - denominator < denominator) {
+            return 1;
+        }
+        return numerator / denominator;
+    }
+
+    //Алгоритм L Кнута над старшими 127 битами u и v (u >= v): шаги Евклида выполняются, пока частное
+    //однозначно определяется приближениями, а элементы матрицы помещаются в лимб.
+    //Серия останавливается, когда приближение v становится короче stop_bits бит
+    lehmer_matrix lehmer_step(const limb_t* u, size_t u_size, const limb_t* v, size_t v_size, size_t stop_bits) {
+        const size_t bits = (u_size - 1) * LIMB_BITS + static_cast<size_t>(std::bit_width(u[u_size - 1]));
+        const size_t shift = bits > 127 ? bits - 127 : 0;
+        dlimb_t x = bit_window(u, u_size, shift);
+        dlimb_t y = bit_window(v, v_size, shift);
+        const size_t limit = stop_bits > shift ? stop_bits - shift : 0;
+        lehmer_matrix m;
+        for (;;) {
+            if (limit != 0 && (limit >= 128 || (y >> limit) == 0)) {
+                break;
+            }
+            // u / 2^shift лежит в [x, x + 1): частное верно, если совпадает на обоих концах интервала
+            dlimb_t q;
+            if (!m.odd) {
+                if (y <= m.c || x < m.b) {
+                    break;
+                }
+                q = small_quotient(x + m.a, y - m.c);
+                if (q == 0 || q != small_quotient(x - m.b, y + m.d)) {
+                    break;
+                }
+            }
+            else {
+                if (y <= m.d || x < m.a) {
+                    break;
+                }
+                q = small_quotient(x - m.a, y + m.c);
+                if (q == 0 || q != small_quotient(x + m.b, y - m.d)) {
+                    break;
+                }
+            }
+            if ((q >> LIMB_BITS) != 0) {
+                break;
+            }
+            const dlimb_t next_c = m.a + q * m.c;
+            const dlimb_t next_d = m.b + q * m.d;
+            if (((next_c | next_d) >> LIMB_BITS) != 0) {
+                break;
+            }
+            m.a = m.c;
+            m.b = m.d;
+            m.c = static_cast<limb_t>(next_c);
+            m.d = static_cast<limb_t>(next_d);
+            m.odd = !m.odd;
+            ++m.steps;
+            const dlimb_t remainder = x - q * y;
+            x = y;
+            y = remainder;
+        }
+        return m;
+    }
+
+    // r = p * x - q * y (n лимбов) при заведомо неотрицательном результате меньше B^n
+    void combine(limb_t* r, const limb_t* x, limb_t p, const limb_t* y, limb_t q, size_t n) {
+        mul_1(r, x, n, p);
+        submul_1(r, y, n, q);
+    }
+
+    // (x, y) = [m0 m1; m2 m3] (x, y)
+    void transform(const BigInteger* m, BigInteger& x, BigInteger& y) {
+        BigInteger next_x = m[0] * x + m[1] * y;
+        BigInteger next_y = m[2] * x + m[3] * y;
+        x = std::move(next_x);
+        y = std::move(next_y);
+    }
+
+    //Шаг деления (x, y) -> (y, x - q y)
+    void division_step(BigInteger& x, BigInteger& y, const BigInteger& q) {
+        BigInteger next_y = x - q * y;
+        x = std::move(y);
+        y = std::move(next_y);
+    }
+}
+
+void BigInteger::lehmer_reduce(BigInteger& u, BigInteger& v, BigInteger* matrix, size_t columns, size_t stop_bits) {
+    //Модули элементов матрицы; знаки чередуются и определяются чётностью числа шагов
+    BigInteger cofactors[4] = { 1, 0, 0, 1 };
+    bool odd = false;
+    //Буферы переиспользуются между сериями шагов
+    BigInteger next_u;
+    BigInteger next_v;
+    BigInteger next_x;
+    BigInteger next_y;
+    BigInteger quotient;
+    BigInteger remainder;
+    next_u.reserve_limbs(u.size);
+    next_v.reserve_limbs(u.size);
+
+    // r = p * x + q * y над модулями
+    auto linear = [](BigInteger& r, const BigInteger& x, limb_t p, const BigInteger& y, limb_t q) {
+        const bool x_longer = x.size >= y.size;
+        const BigInteger& longer = x_longer ? x : y;
+        const BigInteger& shorter = x_longer ? y : x;
+        const size_t n = longer.size;
+        r.resize(n + 1);
+        limb_t* data = r.limbs();
+        data[n] = mul_1(data, longer.limbs(), n, x_longer ? p : q);
+        const limb_t carry = addmul_1(data, shorter.limbs(), shorter.size, x_longer ? q : p);
+        add_to(data + shorter.size, n + 1 - shorter.size, &carry, 1);
+        r.size = normalized_size(data, n + 1);
+        r.is_negative = false;
+    };
+
+    while (!v.isZero() && (stop_bits == 0 || v.bit_length() > stop_bits)) {
+        if (matrix == nullptr && stop_bits == 0 && v.size == 1) {
+            //Остаток от деления на лимб и двоичный НОД машинных слов
+            const limb_t divisor = v.limbs()[0];
+            const limb_t rest = divrem_1(u.limbs(), u.limbs(), u.size, divisor);
+            u.assign_magnitude(std::gcd(divisor, rest));
+            v.assign_magnitude(0);
+            break;
+        }
+        const lehmer_matrix m = lehmer_step(u.limbs(), u.size, v.limbs(), v.size, stop_bits);
+        if (m.steps == 0) {
+            //Частное не определяется старшими битами (обычно оно очень велико) - полное деление
+            divmod(u, v, quotient, remainder);
+            std::swap(u, v);
+            std::swap(v, remainder);
+            if (matrix != nullptr) {
+                // |x'| = |y|, |y'| = |x| + q |y|
+                for (size_t j = 0; j < columns; ++j) {
+                    next_y = cofactors[2 + j] * quotient;
+                    next_y += cofactors[j];
+                    std::swap(cofactors[j], cofactors[2 + j]);
+                    std::swap(cofactors[2 + j], next_y);
+                }
+            }
+            odd = !odd;
+            continue;
+        }
+        const size_t n = u.size;
+        v.resize(n);
+        next_u.resize(n);
+        next_v.resize(n);
+        if (!m.odd) {
+            combine(next_u.limbs(), u.limbs(), m.a, v.limbs(), m.b, n);
+            combine(next_v.limbs(), v.limbs(), m.d, u.limbs(), m.c, n);
+        }
+        else {
+            combine(next_u.limbs(), v.limbs(), m.b, u.limbs(), m.a, n);
+            combine(next_v.limbs(), u.limbs(), m.c, v.limbs(), m.d, n);
+        }
+        next_u.size = normalized_size(next_u.limbs(), n);
+        next_v.size = normalized_size(next_v.limbs(), n);
+        std::swap(u, next_u);
+        std::swap(v, next_v);
+        if (matrix != nullptr) {
+            //Знаки соседних коэффициентов противоположны, поэтому модули складываются
+            for (size_t j = 0; j < columns; ++j) {
+                linear(next_x, cofactors[j], m.a, cofactors[2 + j], m.b);
+                linear(next_y, cofactors[j], m.c, cofactors[2 + j], m.d);
+                std::swap(cofactors[j], next_x);
+                std::swap(cofactors[2 + j], next_y);
+            }
+        }
+        odd = odd != m.odd;
+    }
+
+    if (matrix != nullptr) {
+        //После чётного числа шагов u = |m0| a - |m1| b, v = -|m2| a + |m3| b
+        const bool negative[4] = { odd, !odd, !odd, odd };
+        for (size_t i = 0; i < 4; ++i) {
+            if (columns == 1 && (i & 1) != 0) {
+                matrix[i] = 0;
+                continue;
+            }
+            matrix[i] = std::move(cofactors[i]);
+            matrix[i].is_negative = negative[i] && !matrix[i].isZero();
+        }
+    }
+}
+
+void BigInteger::half_gcd(BigInteger& u, BigInteger& v, BigInteger* matrix) {
+    const size_t target = u.bit_length() / 2 + 1;
+    if (matrix != nullptr) {
+        matrix[0] = 1;
+        matrix[1] = 0;
+        matrix[2] = 0;
+        matrix[3] = 1;
+    }
+    if (v.bit_length() <= target) {
+        return;
+    }
+    if (u.size < std::max<size_t>(thresholds().half_gcd, 4)) {
+        lehmer_reduce(u, v, matrix, 2, target);
+        return;
+    }
+
+    BigInteger step[4];
+    // matrix = m * matrix
+    auto compose = [matrix](const BigInteger* m) {
+        if (matrix != nullptr) {
+            transform(m, matrix[0], matrix[2]);
+            transform(m, matrix[1], matrix[3]);
+        }
+    };
+    //Матрица по старшим битам приближённая: знаки и порядок u >= v >= 0 восстанавливаются
+    //унимодулярными преобразованиями строк, что сохраняет НОД и соотношение (u, v) = matrix (a, b)
+    auto apply = [&](const BigInteger* m) {
+        transform(m, u, v);
+        compose(m);
+        if (u.is_negative) {
+            u.is_negative = false;
+            if (matrix != nullptr) {
+                matrix[0] = -matrix[0];
+                matrix[1] = -matrix[1];
+            }
+        }
+        if (v.is_negative) {
+            v.is_negative = false;
+            if (matrix != nullptr) {
+                matrix[2] = -matrix[2];
+                matrix[3] = -matrix[3];
+            }
+        }
+        if (u < v) {
+            std::swap(u, v);
+            if (matrix != nullptr) {
+                std::swap(matrix[0], matrix[2]);
+                std::swap(matrix[1], matrix[3]);
+            }
+        }
+    };
+
+    //Старшая половина сокращается вдвое - полные числа теряют около четверти длины
+    BigInteger high_u = u >> target;
+    BigInteger high_v = v >> target;
+    half_gcd(high_u, high_v, step);
+    apply(step);
+    if (v.bit_length() <= target) {
+        return;
+    }
+
+    BigInteger quotient;
+    BigInteger remainder;
+    divmod(u, v, quotient, remainder);
+    std::swap(u, v);
+    std::swap(v, remainder);
+    if (matrix != nullptr) {
+        division_step(matrix[0], matrix[2], quotient);
+        division_step(matrix[1], matrix[3], quotient);
+    }
+    if (v.bit_length() <= target) {
+        return;
+    }
+
+    //Вторая рекурсия: старшие 2 (bits - target) бит сокращаются вдвое, и v опускается до target бит
+    const size_t bits = u.bit_length();
+    if (2 * target > bits) {
+        const size_t shift = 2 * target - bits;
+        high_u = u >> shift;
+        high_v = v >> shift;
+        half_gcd(high_u, high_v, step);
+        apply(step);
+    }
+    if (v.bit_length() > target) {
+        lehmer_reduce(u, v, step, 2, target);
+        compose(step);
+    }
+}
+
+void BigInteger::euclid(BigInteger& u, BigInteger& v, BigInteger* cofactors) {
+    BigInteger step[4];
+    BigInteger quotient;
+    BigInteger remainder;
+    bool initial = true;
+    while (v.size >= std::max<size_t>(thresholds().half_gcd, 4)) {
+        half_gcd(u, v, cofactors != nullptr ? step : nullptr);
+        if (cofactors != nullptr) {
+            transform(step, cofactors[0], cofactors[1]);
+        }
+        if (v.isZero()) {
+            break;
+        }
+        //Деление обеспечивает продвижение и для сильно различающихся по длине чисел
+        divmod(u, v, quotient, remainder);
+        std::swap(u, v);
+        std::swap(v, remainder);
+        if (cofactors != nullptr) {
+            division_step(cofactors[0], cofactors[1], quotient);
+        }
+        initial = false;
+    }
+    if (cofactors == nullptr) {
+        lehmer_reduce(u, v, nullptr, 0, 0);
+        return;
+    }
+    if (initial && cofactors[0] == 1 && cofactors[1] == 0) {
+        // (x, y) = matrix (1, 0) - первый столбец
+        lehmer_reduce(u, v, step, 1, 0);
+        cofactors[0] = std::move(step[0]);
+        cofactors[1] = std::move(step[2]);
+        return;
+    }
+    lehmer_reduce(u, v, step, 2, 0);
+    transform(step, cofactors[0], cofactors[1]);
+}
+
+BigInteger gcd(const BigInteger& a, const BigInteger& b) {
+    BigInteger u = a.abs();
+    BigInteger v = b.abs();
+    if (u < v) {
+        std::swap(u, v);
+    }
+    BigInteger::euclid(u, v, nullptr);
+    return u;
+}
+
+BigInteger lcm(const BigInteger& a, const BigInteger& b) {
+    if (a.isZero() || b.isZero()) {
+        return BigInteger(0);
+    }
+    BigInteger result = a.abs() / gcd(a, b);
+    result *= b.abs();
+    return result;
+}
+
+void xgcd(const BigInteger& a, const BigInteger& b, BigInteger& g, BigInteger& s, BigInteger& t) {
+    //Копии аргументов: g, s и t могут совпадать с a или b
+    const BigInteger left = a;
+    const BigInteger right = b;
+    if (right.isZero()) {
+        g = left.abs();
+        s = left.get_is_negative() ? -1 : (left.isZero() ? 0 : 1);
+        t = 0;
+        return;
+    }
+    if (left.isZero()) {
+        g = right.abs();
+        s = 0;
+        t = right.get_is_negative() ? -1 : 1;
+        return;
+    }
+    BigInteger u = left.abs();
+    BigInteger v = right.abs();
+    const bool swapped = u < v;
+    if (swapped) {
+        std::swap(u, v);
+    }
+    const BigInteger first = u;
+    const BigInteger second = v;
+    // u = cofactors[0] * first + (...) * second
+    BigInteger cofactors[2] = { 1, 0 };
+    BigInteger::euclid(u, v, cofactors);
+    BigInteger left_cofactor = swapped ? (u - cofactors[0] * first) / second : std::move(cofactors[0]);
+    if (left.get_is_negative()) {
+        left_cofactor = -left_cofactor;
+    }
+    //Приведение s по модулю |b| / g к наименьшему по модулю представителю
+    const BigInteger period = right.abs() / u;
+    left_cofactor %= period;
+    if (left_cofactor.get_is_negative()) {
+        left_cofactor += period;
+    }
+    if (left_cofactor + left_cofactor > period) {
+        left_cofactor -= period;
+    }
+    t = (u - left_cofactor * left) / right;
+    s = std::move(left_cofactor);
+    g = std::move(u);
+}
+
+BigInteger mod_inverse(const BigInteger& a, const BigInteger& modulus) {
+    if (modulus.get_is_negative() || modulus.isZero()) {
+        throw std::invalid_argument("Modulus must be positive");
+    }
+    BigInteger g;
+    BigInteger s;
+    BigInteger t;
+    xgcd(a % modulus, modulus, g, s, t);
+    if (g != 1) {
+        throw std::invalid_argument("Element is not invertible");
+    }
+    if (s.get_is_negative()) {
+        s += modulus;
+    }
+    return s;
+}
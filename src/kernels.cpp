@@ -0,0 +1,845 @@
+#include "kernels.hpp"
+#include <atomic>
+#include <bit>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+//Сложение, вычитание, умножение на лимб, сравнение, сдвиги и побитовые операции собраны в нескольких
+//вариантах под наборы инструкций. Вариант выбирается один раз по CPUID (или переменной окружения
+//BIGINTEGER_KERNELS) и вызывается через таблицу указателей, поэтому одна сборка без -march работает
+//на любом x86-64. Остальные функции построены поверх них
+namespace biginteger_kernels {
+
+    namespace {
+
+        //Переносимый код на unsigned __int128
+        namespace generic {
+
+            limb_t add_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+                dlimb_t carry = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    dlimb_t sum = (dlimb_t)a[i] + b[i] + carry;
+                    r[i] = static_cast<limb_t>(sum);
+                    carry = sum >> LIMB_BITS;
+                }
+                return static_cast<limb_t>(carry);
+            }
+
+            limb_t sub_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+                limb_t borrow = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    dlimb_t diff = (dlimb_t)a[i] - b[i] - borrow;
+                    r[i] = static_cast<limb_t>(diff);
+                    //При заёме старшая половина diff заполнена единицами
+                    borrow = static_cast<limb_t>(diff >> LIMB_BITS) & 1;
+                }
+                return borrow;
+            }
+
+            limb_t mul_1(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+                dlimb_t carry = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    dlimb_t product = (dlimb_t)a[i] * b + carry;
+                    r[i] = static_cast<limb_t>(product);
+                    carry = product >> LIMB_BITS;
+                }
+                return static_cast<limb_t>(carry);
+            }
+
+            limb_t addmul_1(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+                dlimb_t carry = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    //a * b + r + carry < B^2, переполнения нет
+                    dlimb_t product = (dlimb_t)a[i] * b + r[i] + carry;
+                    r[i] = static_cast<limb_t>(product);
+                    carry = product >> LIMB_BITS;
+                }
+                return static_cast<limb_t>(carry);
+            }
+
+            int cmp(const limb_t* a, const limb_t* b, size_t n) {
+                for (size_t i = n; i-- > 0;) {
+                    if (a[i] != b[i]) {
+                        return (a[i] < b[i]) ? -1 : 1;
+                    }
+                }
+                return 0;
+            }
+
+            limb_t lshift(limb_t* r, const limb_t* a, size_t n, unsigned bits) {
+                limb_t out = a[n - 1] >> (LIMB_BITS - bits);
+                for (size_t i = n - 1; i > 0; --i) {
+                    r[i] = (a[i] << bits) | (a[i - 1] >> (LIMB_BITS - bits));
+                }
+                r[0] = a[0] << bits;
+                return out;
+            }
+
+            limb_t rshift(limb_t* r, const limb_t* a, size_t n, unsigned bits) {
+                limb_t out = a[0] << (LIMB_BITS - bits);
+                for (size_t i = 0; i + 1 < n; ++i) {
+                    r[i] = (a[i] >> bits) | (a[i + 1] << (LIMB_BITS - bits));
+                }
+                r[n - 1] = a[n - 1] >> bits;
+                return out;
+            }
+
+            void and_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    r[i] = a[i] & b[i];
+                }
+            }
+
+            void or_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    r[i] = a[i] | b[i];
+                }
+            }
+
+            void xor_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    r[i] = a[i] ^ b[i];
+                }
+            }
+
+            void com_n(limb_t* r, const limb_t* a, size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    r[i] = ~a[i];
+                }
+            }
+
+            size_t popcount(const limb_t* a, size_t n) {
+                size_t count = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    count += static_cast<size_t>(std::popcount(a[i]));
+                }
+                return count;
+            }
+        }
+
+#if defined(__x86_64__)
+        //unsigned long long и uint64_t - разные типы, интринсики принимают первый
+        static_assert(sizeof(unsigned long long) == sizeof(limb_t));
+        using intrinsic_limb = unsigned long long;
+
+        //Базовый x86-64: цепочки переносов через adc/sbb
+        namespace x86_64 {
+
+            limb_t add_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+                unsigned char carry = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    intrinsic_limb sum;
+                    carry = _addcarry_u64(carry, a[i], b[i], &sum);
+                    r[i] = sum;
+                }
+                return carry;
+            }
+
+            limb_t sub_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+                unsigned char borrow = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    intrinsic_limb diff;
+                    borrow = _subborrow_u64(borrow, a[i], b[i], &diff);
+                    r[i] = diff;
+                }
+                return borrow;
+            }
+        }
+
+        //BMI2 + ADX: умножение на лимб - ассемблерные циклы на mulx, adcx и adox.
+        //Интринсик _addcarryx_u64 компилятор сводит к обычным adc с сохранением флага в регистр,
+        //поэтому две цепочки переносов записаны вручную
+        namespace adx {
+
+            limb_t mul_1(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+                //mulx не трогает флаги, поэтому перенос CF живёт между итерациями;
+                //счётчик уменьшается через lea и проверяется jrcxz, которые флаги тоже не меняют
+                if (n == 0) {
+                    return 0;
+                }
+                limb_t high;
+                limb_t low;
+                limb_t next_high;
+                __asm__(
+                    "xor %k[high], %k[high]\n\t"
+                    "1:\n\t"
+                    "mulx (%[a]), %[low], %[next_high]\n\t"
+                    "adcx %[high], %[low]\n\t"
+                    "mov %[low], (%[r])\n\t"
+                    "mov %[next_high], %[high]\n\t"
+                    "lea 8(%[a]), %[a]\n\t"
+                    "lea 8(%[r]), %[r]\n\t"
+                    "lea -1(%[n]), %[n]\n\t"
+                    "jrcxz 2f\n\t"
+                    "jmp 1b\n\t"
+                    "2:\n\t"
+                    "mov $0, %k[low]\n\t"
+                    "adcx %[low], %[high]"
+                    : [high] "=&r"(high), [low] "=&r"(low), [next_high] "=&r"(next_high),
+                      [a] "+r"(a), [r] "+r"(r), [n] "+c"(n)
+                    : "d"(b)
+                    : "cc", "memory");
+                return high;
+            }
+
+            limb_t addmul_1(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+                //Две независимые цепочки переносов: старшая половина предыдущего произведения (adcx, флаг CF)
+                //и прибавление к r (adox, флаг OF). Итоговый лимб high + CF + OF не переполняется
+                if (n == 0) {
+                    return 0;
+                }
+                limb_t high;
+                limb_t low;
+                limb_t next_high;
+                __asm__(
+                    "xor %k[high], %k[high]\n\t"
+                    "1:\n\t"
+                    "mulx (%[a]), %[low], %[next_high]\n\t"
+                    "adcx %[high], %[low]\n\t"
+                    "adox (%[r]), %[low]\n\t"
+                    "mov %[low], (%[r])\n\t"
+                    "mov %[next_high], %[high]\n\t"
+                    "lea 8(%[a]), %[a]\n\t"
+                    "lea 8(%[r]), %[r]\n\t"
+                    "lea -1(%[n]), %[n]\n\t"
+                    "jrcxz 2f\n\t"
+                    "jmp 1b\n\t"
+                    "2:\n\t"
+                    "mov $0, %k[low]\n\t"
+                    "adcx %[low], %[high]\n\t"
+                    "adox %[low], %[high]"
+                    : [high] "=&r"(high), [low] "=&r"(low), [next_high] "=&r"(next_high),
+                      [a] "+r"(a), [r] "+r"(r), [n] "+c"(n)
+                    : "d"(b)
+                    : "cc", "memory");
+                return high;
+            }
+        }
+
+        //AVX2: сравнение и сдвиги по 4 лимба. Сдвиг влево идёт от старших лимбов, вправо - от младших,
+        //поэтому работа на месте (r == a) корректна: блок читает только ещё не записанные лимбы
+        namespace avx2 {
+
+            __attribute__((target("avx2")))
+            int cmp(const limb_t* a, const limb_t* b, size_t n) {
+                size_t i = n;
+                for (; i >= 4; i -= 4) {
+                    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i - 4));
+                    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i - 4));
+                    if (_mm256_movemask_epi8(_mm256_cmpeq_epi64(x, y)) != -1) {
+                        break;
+                    }
+                }
+                return generic::cmp(a, b, i);
+            }
+
+            __attribute__((target("avx2")))
+            limb_t lshift(limb_t* r, const limb_t* a, size_t n, unsigned bits) {
+                const limb_t out = a[n - 1] >> (LIMB_BITS - bits);
+                const __m128i left = _mm_cvtsi32_si128(static_cast<int>(bits));
+                const __m128i right = _mm_cvtsi32_si128(static_cast<int>(LIMB_BITS - bits));
+                size_t i = n - 1;
+                for (; i >= 4; i -= 4) {
+                    __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i - 3));
+                    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i - 4));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i - 3),
+                        _mm256_or_si256(_mm256_sll_epi64(high, left), _mm256_srl_epi64(low, right)));
+                }
+                for (; i > 0; --i) {
+                    r[i] = (a[i] << bits) | (a[i - 1] >> (LIMB_BITS - bits));
+                }
+                r[0] = a[0] << bits;
+                return out;
+            }
+
+            __attribute__((target("avx2")))
+            limb_t rshift(limb_t* r, const limb_t* a, size_t n, unsigned bits) {
+                const limb_t out = a[0] << (LIMB_BITS - bits);
+                const __m128i right = _mm_cvtsi32_si128(static_cast<int>(bits));
+                const __m128i left = _mm_cvtsi32_si128(static_cast<int>(LIMB_BITS - bits));
+                size_t i = 0;
+                for (; i + 4 < n; i += 4) {
+                    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+                    __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 1));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i),
+                        _mm256_or_si256(_mm256_srl_epi64(low, right), _mm256_sll_epi64(high, left)));
+                }
+                for (; i + 1 < n; ++i) {
+                    r[i] = (a[i] >> bits) | (a[i + 1] << (LIMB_BITS - bits));
+                }
+                r[n - 1] = a[n - 1] >> bits;
+                return out;
+            }
+        }
+
+        //Побитовые операции по 4 лимба; хвост короче вектора - скалярный
+        namespace avx2 {
+
+            __attribute__((target("avx2")))
+            void and_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+                    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), _mm256_and_si256(x, y));
+                }
+                generic::and_n(r + i, a + i, b + i, n - i);
+            }
+
+            __attribute__((target("avx2")))
+            void or_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+                    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), _mm256_or_si256(x, y));
+                }
+                generic::or_n(r + i, a + i, b + i, n - i);
+            }
+
+            __attribute__((target("avx2")))
+            void xor_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+                    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), _mm256_xor_si256(x, y));
+                }
+                generic::xor_n(r + i, a + i, b + i, n - i);
+            }
+
+            __attribute__((target("avx2")))
+            void com_n(limb_t* r, const limb_t* a, size_t n) {
+                const __m256i ones = _mm256_set1_epi64x(-1);
+                size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), _mm256_xor_si256(x, ones));
+                }
+                generic::com_n(r + i, a + i, n - i);
+            }
+
+            //Инструкция popcnt есть на всех процессорах с AVX2
+            __attribute__((target("popcnt")))
+            size_t popcount(const limb_t* a, size_t n) {
+                size_t count = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    count += static_cast<size_t>(__builtin_popcountll(a[i]));
+                }
+                return count;
+            }
+        }
+
+        //AVX-512F: то же по 8 лимбов
+        namespace avx512 {
+
+            __attribute__((target("avx512f")))
+            int cmp(const limb_t* a, const limb_t* b, size_t n) {
+                size_t i = n;
+                for (; i >= 8; i -= 8) {
+                    __m512i x = _mm512_loadu_si512(a + i - 8);
+                    __m512i y = _mm512_loadu_si512(b + i - 8);
+                    if (_mm512_cmpneq_epi64_mask(x, y) != 0) {
+                        break;
+                    }
+                }
+                return generic::cmp(a, b, i);
+            }
+
+            __attribute__((target("avx512f")))
+            limb_t lshift(limb_t* r, const limb_t* a, size_t n, unsigned bits) {
+                const limb_t out = a[n - 1] >> (LIMB_BITS - bits);
+                const __m128i left = _mm_cvtsi32_si128(static_cast<int>(bits));
+                const __m128i right = _mm_cvtsi32_si128(static_cast<int>(LIMB_BITS - bits));
+                size_t i = n - 1;
+                for (; i >= 8; i -= 8) {
+                    __m512i high = _mm512_loadu_si512(a + i - 7);
+                    __m512i low = _mm512_loadu_si512(a + i - 8);
+                    _mm512_storeu_si512(r + i - 7,
+                        _mm512_or_si512(_mm512_sll_epi64(high, left), _mm512_srl_epi64(low, right)));
+                }
+                for (; i > 0; --i) {
+                    r[i] = (a[i] << bits) | (a[i - 1] >> (LIMB_BITS - bits));
+                }
+                r[0] = a[0] << bits;
+                return out;
+            }
+
+            __attribute__((target("avx512f")))
+            limb_t rshift(limb_t* r, const limb_t* a, size_t n, unsigned bits) {
+                const limb_t out = a[0] << (LIMB_BITS - bits);
+                const __m128i right = _mm_cvtsi32_si128(static_cast<int>(bits));
+                const __m128i left = _mm_cvtsi32_si128(static_cast<int>(LIMB_BITS - bits));
+                size_t i = 0;
+                for (; i + 8 < n; i += 8) {
+                    __m512i low = _mm512_loadu_si512(a + i);
+                    __m512i high = _mm512_loadu_si512(a + i + 1);
+                    _mm512_storeu_si512(r + i,
+                        _mm512_or_si512(_mm512_srl_epi64(low, right), _mm512_sll_epi64(high, left)));
+                }
+                for (; i + 1 < n; ++i) {
+                    r[i] = (a[i] >> bits) | (a[i + 1] << (LIMB_BITS - bits));
+                }
+                r[n - 1] = a[n - 1] >> bits;
+                return out;
+            }
+
+            __attribute__((target("avx512f")))
+            void and_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    _mm512_storeu_si512(r + i, _mm512_and_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i)));
+                }
+                avx2::and_n(r + i, a + i, b + i, n - i);
+            }
+
+            __attribute__((target("avx512f")))
+            void or_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    _mm512_storeu_si512(r + i, _mm512_or_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i)));
+                }
+                avx2::or_n(r + i, a + i, b + i, n - i);
+            }
+
+            __attribute__((target("avx512f")))
+            void xor_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    _mm512_storeu_si512(r + i, _mm512_xor_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i)));
+                }
+                avx2::xor_n(r + i, a + i, b + i, n - i);
+            }
+
+            __attribute__((target("avx512f")))
+            void com_n(limb_t* r, const limb_t* a, size_t n) {
+                const __m512i ones = _mm512_set1_epi64(-1);
+                size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    _mm512_storeu_si512(r + i, _mm512_xor_si512(_mm512_loadu_si512(a + i), ones));
+                }
+                avx2::com_n(r + i, a + i, n - i);
+            }
+        }
+#endif
+
+        //Возможности процессора, которые требует вариант
+        enum cpu_feature : unsigned {
+            FEATURE_BMI2_ADX = 1,
+            FEATURE_AVX2 = 2,
+            FEATURE_AVX512 = 4,
+        };
+
+        unsigned detect_features() {
+            unsigned features = 0;
+#if defined(__x86_64__)
+            unsigned eax, ebx, ecx, edx;
+            if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+                return 0;
+            }
+            //Регистры ymm и zmm можно использовать, только если их сохраняет операционная система (XCR0)
+            unsigned long long xcr0 = 0;
+            if ((ecx >> 27) & 1) {
+                unsigned low, high;
+                __asm__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+                xcr0 = (static_cast<unsigned long long>(high) << 32) | low;
+            }
+            if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+                return 0;
+            }
+            if (((ebx >> 8) & 1) && ((ebx >> 19) & 1)) {
+                features |= FEATURE_BMI2_ADX;
+            }
+            if (((ebx >> 5) & 1) && (xcr0 & 0x6) == 0x6) {
+                features |= FEATURE_AVX2;
+            }
+            if (((ebx >> 16) & 1) && (xcr0 & 0xE6) == 0xE6) {
+                features |= FEATURE_AVX512;
+            }
+#endif
+            return features;
+        }
+
+        struct kernel_table {
+            const char* name;
+            unsigned required;
+            limb_t(*add_n)(limb_t*, const limb_t*, const limb_t*, size_t);
+            limb_t(*sub_n)(limb_t*, const limb_t*, const limb_t*, size_t);
+            limb_t(*mul_1)(limb_t*, const limb_t*, size_t, limb_t);
+            limb_t(*addmul_1)(limb_t*, const limb_t*, size_t, limb_t);
+            int(*cmp)(const limb_t*, const limb_t*, size_t);
+            limb_t(*lshift)(limb_t*, const limb_t*, size_t, unsigned);
+            limb_t(*rshift)(limb_t*, const limb_t*, size_t, unsigned);
+            void(*and_n)(limb_t*, const limb_t*, const limb_t*, size_t);
+            void(*or_n)(limb_t*, const limb_t*, const limb_t*, size_t);
+            void(*xor_n)(limb_t*, const limb_t*, const limb_t*, size_t);
+            void(*com_n)(limb_t*, const limb_t*, size_t);
+            size_t(*popcount)(const limb_t*, size_t);
+        };
+
+        //Варианты от простого к лучшему: автоматически выбирается последний поддерживаемый
+        constexpr kernel_table VARIANTS[] = {
+            { .name = "generic", .required = 0,
+                .add_n = generic::add_n, .sub_n = generic::sub_n,
+                .mul_1 = generic::mul_1, .addmul_1 = generic::addmul_1,
+                .cmp = generic::cmp, .lshift = generic::lshift, .rshift = generic::rshift,
+                .and_n = generic::and_n, .or_n = generic::or_n, .xor_n = generic::xor_n,
+                .com_n = generic::com_n, .popcount = generic::popcount },
+#if defined(__x86_64__)
+            { .name = "x86-64", .required = 0,
+                .add_n = x86_64::add_n, .sub_n = x86_64::sub_n,
+                .mul_1 = generic::mul_1, .addmul_1 = generic::addmul_1,
+                .cmp = generic::cmp, .lshift = generic::lshift, .rshift = generic::rshift,
+                .and_n = generic::and_n, .or_n = generic::or_n, .xor_n = generic::xor_n,
+                .com_n = generic::com_n, .popcount = generic::popcount },
+            { .name = "adx", .required = FEATURE_BMI2_ADX,
+                .add_n = x86_64::add_n, .sub_n = x86_64::sub_n,
+                .mul_1 = adx::mul_1, .addmul_1 = adx::addmul_1,
+                .cmp = generic::cmp, .lshift = generic::lshift, .rshift = generic::rshift,
+                .and_n = generic::and_n, .or_n = generic::or_n, .xor_n = generic::xor_n,
+                .com_n = generic::com_n, .popcount = generic::popcount },
+            { .name = "avx2", .required = FEATURE_BMI2_ADX | FEATURE_AVX2,
+                .add_n = x86_64::add_n, .sub_n = x86_64::sub_n,
+                .mul_1 = adx::mul_1, .addmul_1 = adx::addmul_1,
+                .cmp = avx2::cmp, .lshift = avx2::lshift, .rshift = avx2::rshift,
+                .and_n = avx2::and_n, .or_n = avx2::or_n, .xor_n = avx2::xor_n,
+                .com_n = avx2::com_n, .popcount = avx2::popcount },
+            { .name = "avx512", .required = FEATURE_BMI2_ADX | FEATURE_AVX2 | FEATURE_AVX512,
+                .add_n = x86_64::add_n, .sub_n = x86_64::sub_n,
+                .mul_1 = adx::mul_1, .addmul_1 = adx::addmul_1,
+                .cmp = avx512::cmp, .lshift = avx512::lshift, .rshift = avx512::rshift,
+                .and_n = avx512::and_n, .or_n = avx512::or_n, .xor_n = avx512::xor_n,
+                .com_n = avx512::com_n, .popcount = avx2::popcount },
+#endif
+        };
+
+        const kernel_table* find_variant(const char* name) {
+            static const unsigned features = detect_features();
+            if (std::strcmp(name, "auto") == 0) {
+                const kernel_table* best = &VARIANTS[0];
+                for (const kernel_table& table : VARIANTS) {
+                    if ((table.required & features) == table.required) {
+                        best = &table;
+                    }
+                }
+                return best;
+            }
+            for (const kernel_table& table : VARIANTS) {
+                if (std::strcmp(table.name, name) == 0) {
+                    if ((table.required & features) != table.required) {
+                        throw std::invalid_argument("Kernel variant is not supported by this CPU");
+                    }
+                    return &table;
+                }
+            }
+            throw std::invalid_argument("Unknown kernel variant");
+        }
+
+        std::atomic<const kernel_table*>& selected() {
+            //Выбор при первом обращении; пустая или отсутствующая переменная окружения означает "auto".
+            //Неверное значение переменной не бросает из каждой операции: о нём сообщается один раз,
+            //и вариант выбирается автоматически
+            static std::atomic<const kernel_table*> table{ [] {
+                const char* name = std::getenv("BIGINTEGER_KERNELS");
+                if (name == nullptr || *name == '\0') {
+                    return find_variant("auto");
+                }
+                try {
+                    return find_variant(name);
+                }
+                catch (const std::invalid_argument& error) {
+                    std::fprintf(stderr, "BigInteger: BIGINTEGER_KERNELS=%s ignored (%s), using auto\n",
+                        name, error.what());
+                    return find_variant("auto");
+                }
+            }() };
+            return table;
+        }
+
+        const kernel_table& active() {
+            return *selected().load(std::memory_order_relaxed);
+        }
+    }
+
+    const char* kernel_variant() {
+        return active().name;
+    }
+
+    void set_kernel_variant(const char* name) {
+        selected().store(find_variant(name), std::memory_order_relaxed);
+    }
+
+    limb_t add_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+        return active().add_n(r, a, b, n);
+    }
+
+    limb_t add(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn) {
+        limb_t carry = add_n(r, a, b, bn);
+        for (size_t i = bn; i < an; ++i) {
+            limb_t sum = a[i] + carry;
+            carry = (sum < carry) ? 1 : 0;
+            r[i] = sum;
+        }
+        return carry;
+    }
+
+    limb_t add_to(limb_t* r, size_t rn, const limb_t* b, size_t bn) {
+        limb_t carry = add_n(r, r, b, bn);
+        for (size_t i = bn; carry != 0 && i < rn; ++i) {
+            ++r[i];
+            carry = (r[i] == 0) ? 1 : 0;
+        }
+        return carry;
+    }
+
+    limb_t sub_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+        return active().sub_n(r, a, b, n);
+    }
+
+    limb_t sub(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn) {
+        limb_t borrow = sub_n(r, a, b, bn);
+        for (size_t i = bn; i < an; ++i) {
+            limb_t value = a[i];
+            r[i] = value - borrow;
+            borrow = (value < borrow) ? 1 : 0;
+        }
+        return borrow;
+    }
+
+    limb_t sub_1(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+        limb_t borrow = b;
+        for (size_t i = 0; i < n; ++i) {
+            limb_t value = a[i];
+            r[i] = value - borrow;
+            borrow = (value < borrow) ? 1 : 0;
+        }
+        return borrow;
+    }
+
+    bool abs_diff(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn) {
+        //Старшие лимбы a, которых нет у b, решают сравнение сразу
+        bool a_is_less = false;
+        size_t high = an;
+        while (high > bn && a[high - 1] == 0) {
+            --high;
+        }
+        if (high == bn) {
+            a_is_less = cmp(a, b, bn) < 0;
+        }
+        if (a_is_less) {
+            sub_n(r, b, a, bn);
+            for (size_t i = bn; i < an; ++i) {
+                r[i] = 0;
+            }
+        }
+        else {
+            sub(r, a, an, b, bn);
+        }
+        return a_is_less;
+    }
+
+    limb_t mul_1(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+        return active().mul_1(r, a, n, b);
+    }
+
+    limb_t addmul_1(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+        return active().addmul_1(r, a, n, b);
+    }
+
+    limb_t submul_1(limb_t* r, const limb_t* a, size_t n, limb_t b) {
+        dlimb_t borrow = 0;
+        for (size_t i = 0; i < n; ++i) {
+            dlimb_t product = (dlimb_t)a[i] * b + borrow;
+            limb_t low = static_cast<limb_t>(product);
+            borrow = (product >> LIMB_BITS) + ((r[i] < low) ? 1 : 0);
+            r[i] -= low;
+        }
+        return static_cast<limb_t>(borrow);
+    }
+
+    void divexact_1(limb_t* r, const limb_t* a, size_t n, limb_t d) {
+        //Обратный к d по модулю B методом Ньютона: каждая итерация удваивает число верных битов (3 -> 96)
+        limb_t inverse = d;
+        for (int i = 0; i < 5; ++i) {
+            inverse *= 2 - d * inverse;
+        }
+        limb_t borrow = 0;
+        for (size_t i = 0; i < n; ++i) {
+            limb_t value = a[i];
+            limb_t low = value - borrow;
+            borrow = (value < borrow) ? 1 : 0;
+            limb_t quotient = low * inverse;
+            r[i] = quotient;
+            borrow += static_cast<limb_t>(((dlimb_t)quotient * d) >> LIMB_BITS);
+        }
+    }
+
+    limb_t lshift(limb_t* r, const limb_t* a, size_t n, unsigned bits) {
+        return active().lshift(r, a, n, bits);
+    }
+
+    limb_t rshift(limb_t* r, const limb_t* a, size_t n, unsigned bits) {
+        return active().rshift(r, a, n, bits);
+    }
+
+    void and_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+        active().and_n(r, a, b, n);
+    }
+
+    void or_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+        active().or_n(r, a, b, n);
+    }
+
+    void xor_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n) {
+        active().xor_n(r, a, b, n);
+    }
+
+    void com_n(limb_t* r, const limb_t* a, size_t n) {
+        active().com_n(r, a, n);
+    }
+
+    size_t popcount(const limb_t* a, size_t n) {
+        return active().popcount(a, n);
+    }
+
+    limb_t reciprocal_1(limb_t d) {
+        //(B^2 - 1 - d * B) / d < B, деление выполняется один раз на делитель
+        return static_cast<limb_t>((((dlimb_t)~d << LIMB_BITS) | ~limb_t(0)) / d);
+    }
+
+    limb_t divide_2by1(limb_t high, limb_t low, limb_t d, limb_t inverse, limb_t& remainder) {
+        //Частное оценивается умножением на обратную величину и уточняется не более чем двумя поправками
+        dlimb_t estimate = (dlimb_t)inverse * high + (((dlimb_t)high << LIMB_BITS) | low);
+        limb_t quotient = static_cast<limb_t>(estimate >> LIMB_BITS) + 1;
+        limb_t rest = low - quotient * d;
+        if (rest > static_cast<limb_t>(estimate)) {
+            --quotient;
+            rest += d;
+        }
+        if (rest >= d) {
+            ++quotient;
+            rest -= d;
+        }
+        remainder = rest;
+        return quotient;
+    }
+
+    limb_t divrem_1(limb_t* q, const limb_t* a, size_t n, limb_t d) {
+        //Делитель нормализуется сдвигом, делимое сдвигается на лету
+        const unsigned shift = static_cast<unsigned>(std::countl_zero(d));
+        const limb_t normalized = d << shift;
+        const limb_t inverse = reciprocal_1(normalized);
+        limb_t remainder = (shift == 0) ? 0 : a[n - 1] >> (LIMB_BITS - shift);
+        for (size_t i = n; i-- > 0;) {
+            limb_t low = a[i] << shift;
+            if (shift != 0 && i > 0) {
+                low |= a[i - 1] >> (LIMB_BITS - shift);
+            }
+            q[i] = divide_2by1(remainder, low, normalized, inverse, remainder);
+        }
+        return remainder >> shift;
+    }
+
+    limb_t mod_1(const limb_t* a, size_t n, limb_t d) {
+        //Тот же проход, что в divrem_1, но цифры частного отбрасываются
+        const unsigned shift = static_cast<unsigned>(std::countl_zero(d));
+        const limb_t normalized = d << shift;
+        const limb_t inverse = reciprocal_1(normalized);
+        limb_t remainder = (shift == 0) ? 0 : a[n - 1] >> (LIMB_BITS - shift);
+        for (size_t i = n; i-- > 0;) {
+            limb_t low = a[i] << shift;
+            if (shift != 0 && i > 0) {
+                low |= a[i - 1] >> (LIMB_BITS - shift);
+            }
+            divide_2by1(remainder, low, normalized, inverse, remainder);
+        }
+        return remainder >> shift;
+    }
+
+    void divrem_normalized(limb_t* q, limb_t* u, size_t un, const limb_t* d, size_t dn) {
+        const limb_t d_high = d[dn - 1];
+        const limb_t d_next = d[dn - 2];
+        const limb_t inverse = reciprocal_1(d_high);
+        for (size_t j = un - dn; j-- > 0;) {
+            //Оценка цифры частного по двум старшим лимбам окна, ошибка не больше двух
+            const limb_t u_top = u[j + dn];
+            const limb_t u_next = u[j + dn - 1];
+            limb_t q_hat;
+            limb_t r_hat;
+            bool r_hat_overflow = false;
+            if (u_top >= d_high) {
+                //Частное не помещается в лимб: q_hat = B - 1, r_hat = [u_top, u_next] - q_hat * d_high
+                q_hat = ~limb_t(0);
+                r_hat = u_next + d_high;
+                r_hat_overflow = (r_hat < u_next);
+            }
+            else {
+                q_hat = divide_2by1(u_top, u_next, d_high, inverse, r_hat);
+            }
+            while (!r_hat_overflow && (dlimb_t)q_hat * d_next > (((dlimb_t)r_hat << LIMB_BITS) | u[j + dn - 2])) {
+                --q_hat;
+                r_hat += d_high;
+                r_hat_overflow = (r_hat < d_high);
+            }
+            //Вычитание q_hat * d из окна; при отрицательном результате цифра уменьшается ещё на 1
+            limb_t borrow = submul_1(u + j, d, dn, q_hat);
+            limb_t top = u[j + dn];
+            u[j + dn] = top - borrow;
+            if (top < borrow) {
+                --q_hat;
+                u[j + dn] += add_n(u + j, u + j, d, dn);
+            }
+            q[j] = q_hat;
+        }
+    }
+
+    int cmp(const limb_t* a, const limb_t* b, size_t n) {
+        return active().cmp(a, b, n);
+    }
+
+    size_t normalized_size(const limb_t* a, size_t n) {
+        while (n > 1 && a[n - 1] == 0) {
+            --n;
+        }
+        return n;
+    }
+
+    void mul_basecase(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn) {
+        //Первая строка записывается, остальные прибавляются со сдвигом
+        const kernel_table& table = active();
+        r[bn] = table.mul_1(r, b, bn, a[0]);
+        for (size_t i = 1; i < an; ++i) {
+            r[i + bn] = table.addmul_1(r + i, b, bn, a[i]);
+        }
+    }
+
+    void sqr_basecase(limb_t* r, const limb_t* a, size_t n) {
+        const kernel_table& table = active();
+        r[0] = 0;
+        r[2 * n - 1] = 0;
+        if (n > 1) {
+            //Сумма a_i * a_j при i < j: строка i начинается с позиции 2i + 1
+            r[n] = table.mul_1(r + 1, a + 1, n - 1, a[0]);
+            for (size_t i = 1; i + 1 < n; ++i) {
+                r[i + n] = table.addmul_1(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+            }
+            r[2 * n - 1] = table.lshift(r + 1, r + 1, 2 * n - 2, 1);
+        }
+        //Диагональ a_i^2 на позициях 2i, 2i + 1; итоговый перенос нулевой, так как a^2 < B^(2n)
+        limb_t carry = 0;
+        for (size_t i = 0; i < n; ++i) {
+            dlimb_t square = (dlimb_t)a[i] * a[i];
+            dlimb_t low = (dlimb_t)r[2 * i] + static_cast<limb_t>(square) + carry;
+            r[2 * i] = static_cast<limb_t>(low);
+            dlimb_t high = (dlimb_t)r[2 * i + 1] + static_cast<limb_t>(square >> LIMB_BITS) + (low >> LIMB_BITS);
+            r[2 * i + 1] = static_cast<limb_t>(high);
+            carry = static_cast<limb_t>(high >> LIMB_BITS);
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef BIG_INTEGER_KERNELS_HPP
+#define BIG_INTEGER_KERNELS_HPP
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+//Низкоуровневые операции над массивами лимбов (младший лимб первый).
+//Функции не выделяют память и не нормализуют результат.
+namespace biginteger_kernels {
+
+    using limb_t = uint64_t;
+    __extension__ typedef unsigned __int128 dlimb_t;
+    constexpr unsigned LIMB_BITS = 64;
+
+    //Имя активного варианта ядер ("generic", "x86-64", "adx", "avx2", "avx512")
+    const char* kernel_variant();
+
+    //Принудительный выбор варианта по имени ("auto" - лучший поддерживаемый процессором).
+    //Неизвестное или неподдерживаемое имя - std::invalid_argument
+    void set_kernel_variant(const char* name);
+
+    //r = a + b (n лимбов), возвращает перенос. r может совпадать с a или b
+    limb_t add_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n);
+
+    //r = a + b при an >= bn (an лимбов), возвращает перенос
+    limb_t add(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn);
+
+    //r += b при rn >= bn, перенос распространяется только пока он ненулевой
+    limb_t add_to(limb_t* r, size_t rn, const limb_t* b, size_t bn);
+
+    //r = a - b (n лимбов), возвращает заём
+    limb_t sub_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n);
+
+    //r = a - b при an >= bn (an лимбов), возвращает заём
+    limb_t sub(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn);
+
+    //r = a - b (n лимбов), возвращает заём
+    limb_t sub_1(limb_t* r, const limb_t* a, size_t n, limb_t b);
+
+    //r = |a - b| при an >= bn (an лимбов), возвращает true, если a < b
+    bool abs_diff(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn);
+
+    //r = a * b (n лимбов), возвращает старший лимб
+    limb_t mul_1(limb_t* r, const limb_t* a, size_t n, limb_t b);
+
+    //r += a * b (n лимбов), возвращает перенос
+    limb_t addmul_1(limb_t* r, const limb_t* a, size_t n, limb_t b);
+
+    //r -= a * b (n лимбов), возвращает заём
+    limb_t submul_1(limb_t* r, const limb_t* a, size_t n, limb_t b);
+
+    //r = a / d для нечётного d при точном делении (по модулю B^n, подходит и для дополнительного кода)
+    void divexact_1(limb_t* r, const limb_t* a, size_t n, limb_t d);
+
+    //r = a << bits при 0 < bits < LIMB_BITS, возвращает выдвинутые старшие биты. Допускается r >= a
+    limb_t lshift(limb_t* r, const limb_t* a, size_t n, unsigned bits);
+
+    //r = a >> bits при 0 < bits < LIMB_BITS, возвращает выдвинутые биты в старших разрядах лимба. Допускается r <= a
+    limb_t rshift(limb_t* r, const limb_t* a, size_t n, unsigned bits);
+
+    //r = a & b, a | b, a ^ b (n лимбов). r может совпадать с a или b
+    void and_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n);
+    void or_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n);
+    void xor_n(limb_t* r, const limb_t* a, const limb_t* b, size_t n);
+
+    //r = ~a (n лимбов)
+    void com_n(limb_t* r, const limb_t* a, size_t n);
+
+    //Число единичных битов в n лимбах
+    size_t popcount(const limb_t* a, size_t n);
+
+    //q = a / d (n лимбов), возвращает остаток. q может совпадать с a
+    limb_t divrem_1(limb_t* q, const limb_t* a, size_t n, limb_t d);
+
+    //a mod d (n лимбов) без записи частного
+    limb_t mod_1(const limb_t* a, size_t n, limb_t d);
+
+    //Обратная величина нормализованного d (старший бит равен 1): floor((B^2 - 1) / d) - B
+    limb_t reciprocal_1(limb_t d);
+
+    //Деление [high, low] на нормализованное d при high < d с готовой обратной величиной (Мёллер - Гранлунд)
+    limb_t divide_2by1(limb_t high, limb_t low, limb_t d, limb_t inverse, limb_t& remainder);
+
+    //Деление Кнута (алгоритм D). Делитель d нормализован (старший бит d[dn - 1] равен 1), dn >= 2,
+    //старшие dn лимбов u меньше d. Частное (un - dn лимбов) пишется в q, остаток остаётся в u[0, dn)
+    void divrem_normalized(limb_t* q, limb_t* u, size_t un, const limb_t* d, size_t dn);
+
+    //Сравнение n-лимбовых чисел: -1, 0 или 1
+    int cmp(const limb_t* a, const limb_t* b, size_t n);
+
+    //Длина без ведущих нулей (минимум 1)
+    size_t normalized_size(const limb_t* a, size_t n);
+
+    //Умножение в столбик: r = a * b, r занимает an + bn лимбов и не пересекается с a и b
+    void mul_basecase(limb_t* r, const limb_t* a, size_t an, const limb_t* b, size_t bn);
+
+    //Квадрат в столбик: r = a^2, r занимает 2n лимбов и не пересекается с a.
+    //Каждое попарное произведение a_i * a_j (i < j) считается один раз и удваивается сдвигом
+    void sqr_basecase(limb_t* r, const limb_t* a, size_t n);
+}
+
+#endif
@@ -0,0 +1,319 @@
+#include "../include/biginteger.hpp"
+#include "kernels.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <stdexcept>
+#include <vector>
+
+using namespace biginteger_kernels;
+
+//---------------------------------------М О Д У Л Ь Н А Я   А Р И Ф М Е Т И К А---------------------------------------------------------
+
+namespace {
+
+    //Ширина скользящего окна по длине показателя (в битах): таблица из 2^(k-1) нечётных степеней
+    //окупается, когда экономит больше умножений, чем стоит её заполнение
+    size_t window_bits(size_t exponent_bits) {
+        if (exponent_bits <= 7) return 1;
+        if (exponent_bits <= 25) return 2;
+        if (exponent_bits <= 81) return 3;
+        if (exponent_bits <= 241) return 4;
+        if (exponent_bits <= 673) return 5;
+        if (exponent_bits <= 1793) return 6;
+        return 7;
+    }
+
+    //x mod 2^bits для неотрицательного результата (у отрицательного x - дополнительный код)
+    BigInteger low_bits(const BigInteger& x, size_t bits) {
+        return x & ((BigInteger(1) << bits) - 1);
+    }
+
+    //base^exponent mod 2^bits: квадраты усекаются до bits бит
+    BigInteger pow_mod_power_of_two(const BigInteger& base, const BigInteger& exponent, size_t bits) {
+        const BigInteger reduced = low_bits(base, bits);
+        BigInteger result = 1;
+        for (size_t i = exponent.bit_length(); i-- > 0;) {
+            result = low_bits(result.square(), bits);
+            if (exponent.test_bit(i)) {
+                result = low_bits(result * reduced, bits);
+            }
+        }
+        return low_bits(result, bits);
+    }
+
+    //q^(-1) mod 2^bits для нечётного q подъёмом Гензеля: y = y * (2 - q * y) удваивает число верных бит
+    BigInteger inverse_mod_power_of_two(const BigInteger& q, size_t bits) {
+        BigInteger y = 1;
+        for (size_t precision = 1; precision < bits;) {
+            precision = std::min(2 * precision, bits);
+            y = low_bits(y * (2 - low_bits(q, precision) * y), precision);
+        }
+        return y;
+    }
+}
+
+MontgomeryContext::MontgomeryContext(const BigInteger& modulus) : modulus_value(modulus) {
+    if (modulus.is_negative || modulus.isZero() || (modulus.limbs()[0] & 1) == 0) {
+        throw std::invalid_argument("Montgomery modulus must be odd and positive");
+    }
+    n = modulus.size;
+    //N^(-1) mod 2^64 методом Ньютона: N0 верно в 3 младших битах, каждый шаг удваивает их число
+    const limb_t low = modulus.limbs()[0];
+    limb_t x = low;
+    for (int i = 0; i < 5; ++i) {
+        x *= 2 - low * x;
+    }
+    inverse = limb_t(0) - x;
+    // R^2 mod N, R = B^n
+    r_squared = (BigInteger(1) << (2 * n * LIMB_BITS)) % modulus;
+}
+
+const BigInteger& MontgomeryContext::modulus() const {
+    return modulus_value;
+}
+
+void MontgomeryContext::reduce(uint64_t* result, uint64_t* t) const {
+    const limb_t* modulus_limbs = modulus_value.limbs();
+    //Каждый шаг обнуляет t[i]; перенос addmul_1 сохраняется на его месте и добавляется в конце одним проходом
+    for (size_t i = 0; i < n; ++i) {
+        const limb_t m = t[i] * inverse;
+        t[i] = addmul_1(t + i, modulus_limbs, n, m);
+    }
+    const limb_t carry = add_n(result, t + n, t, n);
+    // t / R < 2N: хватает одного вычитания
+    if (carry != 0 || cmp(result, modulus_limbs, n) >= 0) {
+        sub_n(result, result, modulus_limbs, n);
+    }
+}
+
+void MontgomeryContext::multiply(uint64_t* result, const uint64_t* a, const uint64_t* b, uint64_t* scratch) const {
+    //Совпадающие указатели уходят в ветку возведения в квадрат
+    BigInteger::multiply_magnitudes(scratch, a, n, b, n);
+    reduce(result, scratch);
+}
+
+void MontgomeryContext::load(uint64_t* target, const BigInteger& value) const {
+    const BigInteger* source = &value;
+    BigInteger reduced;
+    if (value.is_negative || value.size > n || (value.size == n && cmp(value.limbs(), modulus_value.limbs(), n) >= 0)) {
+        reduced = value % modulus_value;
+        if (reduced.is_negative) {
+            reduced += modulus_value;
+        }
+        source = &reduced;
+    }
+    std::copy(source->limbs(), source->limbs() + source->size, target);
+    std::fill(target + source->size, target + n, 0);
+}
+
+BigInteger MontgomeryContext::to_montgomery(const BigInteger& value) const {
+    // x * R = REDC(x * R^2)
+    std::pmr::vector<limb_t> buffer(4 * n, BigInteger::default_memory_resource());
+    limb_t* x = buffer.data();
+    limb_t* r2 = x + n;
+    limb_t* scratch = r2 + n;
+    load(x, value);
+    load(r2, r_squared);
+    multiply(x, x, r2, scratch);
+    return BigInteger::from_limbs(x, n);
+}
+
+BigInteger MontgomeryContext::from_montgomery(const BigInteger& value) const {
+    std::pmr::vector<limb_t> buffer(3 * n, 0, BigInteger::default_memory_resource());
+    limb_t* x = buffer.data();
+    limb_t* t = x + n;
+    load(t, value);
+    reduce(x, t);
+    return BigInteger::from_limbs(x, n);
+}
+
+BigInteger MontgomeryContext::multiply(const BigInteger& left, const BigInteger& right) const {
+    std::pmr::vector<limb_t> buffer(4 * n, BigInteger::default_memory_resource());
+    limb_t* a = buffer.data();
+    limb_t* b = a + n;
+    limb_t* scratch = b + n;
+    load(a, left);
+    load(b, right);
+    multiply(a, a, b, scratch);
+    return BigInteger::from_limbs(a, n);
+}
+
+BigInteger MontgomeryContext::pow(const BigInteger& base, const BigInteger& exponent) const {
+    if (exponent.is_negative) {
+        throw std::invalid_argument("Negative exponent");
+    }
+    const size_t bits = exponent.bit_length();
+    if (bits == 0) {
+        return BigInteger(1) % modulus_value;
+    }
+    const limb_t* exponent_limbs = exponent.limbs();
+    auto bit = [exponent_limbs](size_t index) {
+        return ((exponent_limbs[index / LIMB_BITS] >> (index % LIMB_BITS)) & 1) != 0;
+    };
+
+    // table[j] = base^(2j + 1) в форме Монтгомери
+    const size_t k = window_bits(bits);
+    const size_t table_size = size_t(1) << (k - 1);
+    std::pmr::vector<limb_t> buffer((table_size + 4) * n, BigInteger::default_memory_resource());
+    limb_t* table = buffer.data();
+    limb_t* accumulator = table + table_size * n;
+    limb_t* base_square = accumulator + n;
+    limb_t* scratch = base_square + n;
+    load(accumulator, base);
+    load(base_square, r_squared);
+    multiply(table, accumulator, base_square, scratch);
+    if (table_size > 1) {
+        multiply(base_square, table, table, scratch);
+        for (size_t j = 1; j < table_size; ++j) {
+            multiply(table + j * n, table + (j - 1) * n, base_square, scratch);
+        }
+    }
+
+    //Слева направо: нулевые биты - возведение в квадрат, иначе окно до k бит, оканчивающееся единицей
+    bool started = false;
+    size_t position = bits;
+    while (position > 0) {
+        if (!bit(position - 1)) {
+            multiply(accumulator, accumulator, accumulator, scratch);
+            --position;
+            continue;
+        }
+        size_t low = position >= k ? position - k : 0;
+        while (!bit(low)) {
+            ++low;
+        }
+        size_t window = 0;
+        for (size_t i = position; i-- > low;) {
+            window = (window << 1) | (bit(i) ? 1 : 0);
+        }
+        const limb_t* power = table + (window >> 1) * n;
+        if (started) {
+            for (size_t i = low; i < position; ++i) {
+                multiply(accumulator, accumulator, accumulator, scratch);
+            }
+            multiply(accumulator, accumulator, power, scratch);
+        }
+        else {
+            std::copy(power, power + n, accumulator);
+            started = true;
+        }
+        position = low;
+    }
+
+    //Выход из формы Монтгомери: REDC(x)
+    std::copy(accumulator, accumulator + n, scratch);
+    std::fill(scratch + n, scratch + 2 * n, 0);
+    reduce(accumulator, scratch);
+    return BigInteger::from_limbs(accumulator, n);
+}
+
+BigInteger pow_mod(const BigInteger& base, const BigInteger& exponent, const BigInteger& modulus) {
+    if (modulus.get_is_negative() || modulus.isZero()) {
+        throw std::invalid_argument("Modulus must be positive");
+    }
+    if (exponent.get_is_negative()) {
+        throw std::invalid_argument("Negative exponent");
+    }
+    if (modulus.test_bit(0)) {
+        return MontgomeryContext(modulus).pow(base, exponent);
+    }
+    //Чётный модуль 2^s * q: x1 = base^e mod q (Монтгомери), x2 = base^e mod 2^s,
+    //x = x1 + q * ((x2 - x1) * q^(-1) mod 2^s)
+    size_t s = 0;
+    while (!modulus.test_bit(s)) {
+        ++s;
+    }
+    const BigInteger q = modulus >> s;
+    const BigInteger x2 = pow_mod_power_of_two(base, exponent, s);
+    if (q == 1) {
+        return x2;
+    }
+    const BigInteger x1 = MontgomeryContext(q).pow(base, exponent);
+    return x1 + q * low_bits((x2 - x1) * inverse_mod_power_of_two(q, s), s);
+}
+
+//---------------------------------------П Р И В Е Д Е Н И Е   П О   Б А Р Р Е Т Т У---------------------------------------------------------
+
+BarrettReducer::BarrettReducer(const BigInteger& modulus) : modulus_value(modulus) {
+    if (modulus.is_negative || modulus.isZero()) {
+        throw std::invalid_argument("Modulus must be positive");
+    }
+    n = modulus.size;
+    reciprocal = (BigInteger(1) << (2 * n * LIMB_BITS)) / modulus;
+}
+
+const BigInteger& BarrettReducer::modulus() const {
+    return modulus_value;
+}
+
+size_t BarrettReducer::scratch_size() const {
+    //q2 = q1 * mu, q3 * N и остаток r по n + 1 лимбов
+    return (n + 1 + reciprocal.size) + (reciprocal.size + n) + (n + 1);
+}
+
+void BarrettReducer::reduce_in_place(BigInteger& value, uint64_t* scratch) const {
+    const bool negative = value.is_negative;
+    const limb_t* modulus_limbs = modulus_value.limbs();
+    if (value.size > 2 * n) {
+        value.is_negative = false;
+        value %= modulus_value;
+    }
+    else if (value.size >= n) {
+        //q1 = x / B^(n-1), q3 = q1 * mu / B^(n+1) - оценка частного, меньшая точного не более чем на 2
+        limb_t* x = value.limbs();
+        const limb_t* q1 = x + n - 1;
+        const size_t q1_size = value.size - n + 1;
+        const size_t q2_size = q1_size + reciprocal.size;
+        limb_t* q2 = scratch;
+        limb_t* q3_modulus = q2 + q2_size;
+        limb_t* r = scratch + scratch_size() - (n + 1);
+        if (q1_size >= reciprocal.size) {
+            BigInteger::multiply_magnitudes(q2, q1, q1_size, reciprocal.limbs(), reciprocal.size);
+        }
+        else {
+            BigInteger::multiply_magnitudes(q2, reciprocal.limbs(), reciprocal.size, q1, q1_size);
+        }
+        const limb_t* q3 = q2 + n + 1;
+        const size_t q3_size = q2_size > n + 1 ? normalized_size(q3, q2_size - n - 1) : 0;
+        //r = (x - q3 * N) mod B^(n+1); настоящий остаток меньше 3N < B^(n+1), поэтому перенос за границу не нужен
+        std::copy(x, x + std::min(value.size, n + 1), r);
+        std::fill(r + std::min(value.size, n + 1), r + n + 1, 0);
+        if (q3_size > 0) {
+            if (q3_size >= n) {
+                BigInteger::multiply_magnitudes(q3_modulus, q3, q3_size, modulus_limbs, n);
+            }
+            else {
+                BigInteger::multiply_magnitudes(q3_modulus, modulus_limbs, n, q3, q3_size);
+            }
+            sub_n(r, r, q3_modulus, n + 1);
+        }
+        while (r[n] != 0 || cmp(r, modulus_limbs, n) >= 0) {
+            r[n] -= sub_n(r, r, modulus_limbs, n);
+        }
+        std::copy(r, r + n, x);
+        value.size = normalized_size(x, n);
+        value.is_negative = false;
+    }
+    else {
+        value.is_negative = false;
+    }
+    //-x mod N = N - (|x| mod N)
+    if (negative && !value.isZero()) {
+        value = modulus_value - value;
+    }
+}
+
+BigInteger BarrettReducer::reduce(const BigInteger& value) const {
+    std::pmr::vector<limb_t> scratch(scratch_size(), BigInteger::default_memory_resource());
+    BigInteger result = value;
+    reduce_in_place(result, scratch.data());
+    return result;
+}
+
+void BarrettReducer::reduce(std::span<BigInteger> values) const {
+    std::pmr::vector<limb_t> scratch(scratch_size(), BigInteger::default_memory_resource());
+    for (BigInteger& value : values) {
+        reduce_in_place(value, scratch.data());
+    }
+}
@@ -0,0 +1,288 @@
+#include "../include/biginteger.hpp"
+#include "kernels.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using namespace biginteger_kernels;
+
+//---------------------------------------У М Н О Ж Е Н И Е   М О Д У Л Е Й-----------------------------------------------------------
+
+//Смена знака числа в дополнительном коде
+static void negate(limb_t* x, size_t n) {
+    limb_t carry = 1;
+    for (size_t i = 0; i < n; ++i) {
+        x[i] = ~x[i] + carry;
+        carry = (carry != 0 && x[i] == 0) ? 1 : 0;
+    }
+}
+
+//Точное деление числа в дополнительном коде на небольшое целое
+static void divide_exact_signed(limb_t* x, size_t n, int divisor) {
+    limb_t magnitude = static_cast<limb_t>(divisor < 0 ? -divisor : divisor);
+    unsigned shift = 0;
+    while (magnitude % 2 == 0) {
+        magnitude /= 2;
+        ++shift;
+    }
+    if (shift > 0) {
+        //Арифметический сдвиг: освободившиеся старшие биты заполняются знаком
+        bool negative = (x[n - 1] >> (LIMB_BITS - 1)) != 0;
+        rshift(x, x, n, shift);
+        if (negative) {
+            x[n - 1] |= ~(~limb_t(0) >> shift);
+        }
+    }
+    if (magnitude > 1) {
+        divexact_1(x, x, n, magnitude);
+    }
+    if (divisor < 0) {
+        negate(x, n);
+    }
+}
+
+//c = prev - point * c (n лимбов, дополнительный код)
+static void sub_scaled(limb_t* c, const limb_t* prev, size_t n, int point) {
+    if (point == 0) {
+        std::copy(prev, prev + n, c);
+        return;
+    }
+    mul_1(c, c, n, static_cast<limb_t>(point < 0 ? -point : point));
+    if (point > 0) {
+        sub_n(c, prev, c, n);
+    }
+    else {
+        add_n(c, prev, c, n);
+    }
+}
+
+//Чётная и нечётная части многочлена из кусков x в точке point: x(point) = even + odd, x(-point) = even - odd
+static void evaluate_split(limb_t* even, limb_t* odd, size_t width, const limb_t* x, size_t x_size,
+    size_t piece, size_t parts, limb_t point) {
+    std::fill(even, even + width, 0);
+    std::fill(odd, odd + width, 0);
+    for (size_t i = parts; i-- > 0;) {
+        limb_t* target = (i % 2 == 0) ? even : odd;
+        mul_1(target, target, width, point * point);
+        size_t offset = i * piece;
+        add_to(target, width, x + offset, std::min(piece, x_size - offset));
+    }
+    mul_1(odd, odd, width, point);
+}
+
+static bool toom_fits(size_t a_size, size_t b_size, size_t parts) {
+    //Старшие куски обоих множителей должны быть непустыми
+    size_t piece = (a_size + parts - 1) / parts;
+    return b_size > (parts - 1) * piece;
+}
+
+biginteger_thresholds& BigInteger::thresholds() {
+    static biginteger_thresholds limits;
+    return limits;
+}
+
+std::string BigInteger::kernel_variant() {
+    return biginteger_kernels::kernel_variant();
+}
+
+void BigInteger::set_kernel_variant(const std::string& name) {
+    biginteger_kernels::set_kernel_variant(name.c_str());
+}
+
+void BigInteger::multiply_magnitudes(limb_t* result, const limb_t* a, size_t a_size,
+    const limb_t* b, size_t b_size) {
+    const biginteger_thresholds& limits = thresholds();
+    //Совпадающие множители (x * x, а также квадраты внутри Карацубы, Тоома и NTT) возводятся в квадрат:
+    //попарные произведения считаются один раз, преобразования и вычисления в точках - для одного операнда
+    const bool squaring = (a == b && a_size == b_size);
+    //Нижние границы нужны, чтобы рекурсия уменьшала размер при любых порогах
+    if (squaring && b_size < std::max<size_t>(limits.karatsuba_square, 4)) {
+        sqr_basecase(result, a, a_size);
+    }
+    else if (!squaring && b_size < std::max<size_t>(limits.karatsuba, 4)) {
+        mul_basecase(result, a, a_size, b, b_size);
+    }
+    else if (b_size >= std::max<size_t>(limits.ntt, 64)) {
+        multiply_ntt(result, a, a_size, b, b_size);
+    }
+    else if (a_size >= 2 * b_size) {
+        multiply_unbalanced(result, a, a_size, b, b_size);
+    }
+    else if (b_size >= std::max<size_t>(limits.toom4, 32) && toom_fits(a_size, b_size, 4)) {
+        multiply_toom(result, a, a_size, b, b_size, 4);
+    }
+    else if (b_size >= std::max<size_t>(limits.toom3, 16) && toom_fits(a_size, b_size, 3)) {
+        multiply_toom(result, a, a_size, b, b_size, 3);
+    }
+    else {
+        multiply_karatsuba(result, a, a_size, b, b_size);
+    }
+}
+
+void BigInteger::multiply_unbalanced(limb_t* result, const limb_t* a, size_t a_size,
+    const limb_t* b, size_t b_size) {
+    //Длинный множитель режется на куски по b_size лимбов, каждый кусок умножается как сбалансированный
+    const size_t result_size = a_size + b_size;
+    std::fill(result, result + result_size, 0);
+    std::pmr::vector<limb_t> product(2 * b_size, default_memory_resource());
+    for (size_t offset = 0; offset < a_size; offset += b_size) {
+        size_t chunk = std::min(b_size, a_size - offset);
+        if (chunk == b_size) {
+            multiply_magnitudes(product.data(), a + offset, chunk, b, b_size);
+        }
+        else {
+            multiply_magnitudes(product.data(), b, b_size, a + offset, chunk);
+        }
+        add_to(result + offset, result_size - offset, product.data(), chunk + b_size);
+    }
+}
+
+void BigInteger::multiply_karatsuba(limb_t* result, const limb_t* a, size_t a_size,
+    const limb_t* b, size_t b_size) {
+    // a = a1 * B^half + a0, b = b1 * B^half + b0, при этом b_size >= half
+    // a * b = z2 * B^(2 half) + (z0 + z2 - (a0 - a1)(b0 - b1)) * B^half + z0
+    const size_t half = (a_size + 1) / 2;
+    const size_t a_high = a_size - half;
+    const size_t b_high = b_size - half;
+    const size_t result_size = a_size + b_size;
+    const bool squaring = (a == b && a_size == b_size);
+
+    multiply_magnitudes(result, a, half, b, half);
+    if (b_high > 0) {
+        multiply_magnitudes(result + 2 * half, a + half, a_high, b + half, b_high);
+    }
+    else {
+        std::fill(result + 2 * half, result + result_size, 0);
+    }
+
+    std::pmr::vector<limb_t> buffer(6 * half + 1, default_memory_resource());
+    limb_t* a_diff = buffer.data();
+    limb_t* b_diff = a_diff + half;
+    limb_t* middle = b_diff + half;
+    limb_t* sum = middle + 2 * half;
+    bool a_negative = abs_diff(a_diff, a, half, a + half, a_high);
+    bool b_negative = a_negative;
+    if (squaring) {
+        // (a0 - a1)^2: средний член - тоже квадрат
+        b_diff = a_diff;
+    }
+    else {
+        b_negative = abs_diff(b_diff, b, half, b + half, b_high);
+    }
+    multiply_magnitudes(middle, a_diff, half, b_diff, half);
+
+    // sum = z0 + z2 -+ |a0 - a1| * |b0 - b1|
+    sum[2 * half] = add(sum, result, 2 * half, result + 2 * half, a_high + b_high);
+    if (a_negative == b_negative) {
+        sub(sum, sum, 2 * half + 1, middle, 2 * half);
+    }
+    else {
+        add(sum, sum, 2 * half + 1, middle, 2 * half);
+    }
+    add_to(result + half, result_size - half, sum, normalized_size(sum, 2 * half + 1));
+}
+
+void BigInteger::multiply_toom(limb_t* result, const limb_t* a, size_t a_size,
+    const limb_t* b, size_t b_size, size_t parts) {
+    //Множители - многочлены степени parts - 1 от x = B^piece, произведение имеет степень degree.
+    //Значения в точках 0, 1, -1, 2, -2, ... и на бесконечности интерполируются формой Ньютона.
+    //Промежуточные величины могут быть отрицательными и хранятся в дополнительном коде ширины width.
+    const size_t piece = (a_size + parts - 1) / parts;
+    const size_t degree = 2 * parts - 2;
+    const size_t points_count = degree;
+    const size_t width = 2 * piece + 4;
+    const size_t eval_width = piece + 1;
+    //При возведении в квадрат значения b в точках совпадают со значениями a и не вычисляются
+    const bool squaring = (a == b && a_size == b_size);
+    std::vector<int> points(points_count);
+    for (size_t j = 0; j < points_count; ++j) {
+        points[j] = (j % 2 == 1) ? static_cast<int>((j + 1) / 2) : -static_cast<int>(j / 2);
+    }
+
+    std::pmr::vector<limb_t> buffer((2 * points_count + 1) * width + 6 * eval_width, 0, default_memory_resource());
+    limb_t* values = buffer.data();
+    limb_t* coefficients = values + points_count * width;
+    limb_t* at_infinity = coefficients + points_count * width;
+    limb_t* a_even = at_infinity + width;
+    limb_t* a_odd = a_even + eval_width;
+    limb_t* b_even = a_odd + eval_width;
+    limb_t* b_odd = b_even + eval_width;
+    limb_t* a_value = b_odd + eval_width;
+    limb_t* b_value = squaring ? a_value : a_value + eval_width;
+
+    //Произведение модулей со знаком в values_j
+    auto store_product = [&](limb_t* target, const limb_t* x, size_t x_size,
+        const limb_t* y, size_t y_size, bool negative) {
+        x_size = normalized_size(x, x_size);
+        y_size = normalized_size(y, y_size);
+        if (x_size >= y_size) {
+            multiply_magnitudes(target, x, x_size, y, y_size);
+        }
+        else {
+            multiply_magnitudes(target, y, y_size, x, x_size);
+        }
+        std::fill(target + x_size + y_size, target + width, 0);
+        if (negative) {
+            negate(target, width);
+        }
+    };
+
+    const size_t top_offset = (parts - 1) * piece;
+    store_product(at_infinity, a + top_offset, a_size - top_offset, b + top_offset, b_size - top_offset, false);
+    store_product(values, a, piece, b, piece, false);
+    for (size_t j = 1; j < points_count; j += 2) {
+        limb_t point = static_cast<limb_t>(points[j]);
+        evaluate_split(a_even, a_odd, eval_width, a, a_size, piece, parts, point);
+        add_n(a_value, a_even, a_odd, eval_width);
+        if (!squaring) {
+            evaluate_split(b_even, b_odd, eval_width, b, b_size, piece, parts, point);
+            add_n(b_value, b_even, b_odd, eval_width);
+        }
+        store_product(values + j * width, a_value, eval_width, b_value, eval_width, false);
+        if (j + 1 < points_count) {
+            bool a_negative = abs_diff(a_value, a_even, eval_width, a_odd, eval_width);
+            bool b_negative = squaring ? a_negative : abs_diff(b_value, b_even, eval_width, b_odd, eval_width);
+            store_product(values + (j + 1) * width, a_value, eval_width, b_value, eval_width, a_negative != b_negative);
+        }
+    }
+
+    //Без старшего члена остаётся многочлен степени degree - 1, он задаётся points_count точками
+    for (size_t j = 1; j < points_count; ++j) {
+        limb_t power = 1;
+        for (size_t k = 0; k < degree; ++k) {
+            power *= static_cast<limb_t>(points[j] < 0 ? -points[j] : points[j]);
+        }
+        submul_1(values + j * width, at_infinity, width, power);
+    }
+
+    //Разделённые разности Ньютона; все деления точные
+    for (size_t level = 1; level < points_count; ++level) {
+        for (size_t j = points_count - 1; j >= level; --j) {
+            limb_t* current = values + j * width;
+            sub_n(current, current, current - width, width);
+            divide_exact_signed(current, width, points[j] - points[j - level]);
+        }
+    }
+
+    //Переход от базиса Ньютона к коэффициентам: c(x) = c(x) * (x - x_j) + values_j
+    std::copy(values + (points_count - 1) * width, values + points_count * width, coefficients);
+    for (size_t j = points_count - 1; j-- > 0;) {
+        size_t top = points_count - 1 - j;
+        std::copy(coefficients + (top - 1) * width, coefficients + top * width, coefficients + top * width);
+        for (size_t k = top - 1; k > 0; --k) {
+            sub_scaled(coefficients + k * width, coefficients + (k - 1) * width, width, points[j]);
+        }
+        sub_scaled(coefficients, values + j * width, width, points[j]);
+    }
+
+    //Сборка результата: коэффициенты неотрицательны и складываются со сдвигом на piece лимбов
+    const size_t result_size = a_size + b_size;
+    std::fill(result, result + result_size, 0);
+    for (size_t i = 0; i <= degree; ++i) {
+        const limb_t* coefficient = (i < degree) ? coefficients + i * width : at_infinity;
+        size_t offset = i * piece;
+        add_to(result + offset, result_size - offset, coefficient, normalized_size(coefficient, width));
+    }
+}
@@ -0,0 +1,277 @@
+#include "../include/biginteger.hpp"
+#include "kernels.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+using namespace biginteger_kernels;
+
+//---------------------------------------Т Е О Р Е Т И К О - Ч И С Л О В О Е   П Р Е О Б Р А З О В А Н И Е---------------------------
+
+__extension__ typedef unsigned __int128 uint128_t;
+
+namespace {
+
+    //Простые вида c * 2^k + 1 < 2^62 и их первообразные корни.
+    //Произведение модулей ~2^185 превышает любой коэффициент свёртки длины до 2^48.
+    struct ntt_prime {
+        uint64_t modulus;
+        uint64_t root;
+    };
+    constexpr ntt_prime PRIMES[3] = {
+        { 4601552919265804289ULL, 3 },  // 4087 * 2^50 + 1
+        { 4595360469778169857ULL, 5 },  // 8163 * 2^49 + 1
+        { 4585508845593296897ULL, 5 },  // 16291 * 2^48 + 1
+    };
+    constexpr size_t MAX_TRANSFORM_SIZE = size_t(1) << 48;
+
+    uint64_t power_mod(uint64_t base, uint64_t exponent, uint64_t modulus) {
+        uint64_t result = 1;
+        while (exponent > 0) {
+            if (exponent & 1) {
+                result = static_cast<uint64_t>((uint128_t)result * base % modulus);
+            }
+            base = static_cast<uint64_t>((uint128_t)base * base % modulus);
+            exponent >>= 1;
+        }
+        return result;
+    }
+
+    //Арифметика по модулю p < 2^62 в форме Монтгомери, R = 2^64
+    struct montgomery {
+        uint64_t p;
+        uint64_t p_neg_inverse;
+        uint64_t r_squared;
+
+        explicit montgomery(uint64_t modulus) : p(modulus) {
+            uint64_t inverse = modulus;
+            for (int i = 0; i < 5; ++i) {
+                inverse *= 2 - modulus * inverse;
+            }
+            p_neg_inverse = ~inverse + 1;
+            uint128_t r_mod = ((uint128_t)1 << 64) % modulus;
+            r_squared = static_cast<uint64_t>(r_mod * r_mod % modulus);
+        }
+
+        uint64_t reduce(uint128_t value) const {
+            uint64_t m = static_cast<uint64_t>(value) * p_neg_inverse;
+            uint64_t result = static_cast<uint64_t>((value + (uint128_t)m * p) >> 64);
+            return (result >= p) ? result - p : result;
+        }
+        //a * b / R; если b в форме Монтгомери, то просто a * b
+        uint64_t mul(uint64_t a, uint64_t b) const {
+            return reduce((uint128_t)a * b);
+        }
+        uint64_t to_montgomery(uint64_t a) const {
+            return mul(a, r_squared);
+        }
+        uint64_t add(uint64_t a, uint64_t b) const {
+            uint64_t sum = a + b;
+            return (sum >= p) ? sum - p : sum;
+        }
+        uint64_t sub(uint64_t a, uint64_t b) const {
+            return (a >= b) ? a - b : a + p - b;
+        }
+    };
+
+    //Преобразование по одному модулю. Таблица корней: roots[len + j] = w_{2len}^j (форма Монтгомери)
+    struct transform {
+        montgomery field;
+        uint64_t root;
+        std::vector<uint64_t> roots;
+        std::vector<uint64_t> inverse_roots;
+
+        explicit transform(const ntt_prime& prime) : field(prime.modulus), root(prime.root) {}
+
+        //Таблицы только растут: корни меньших уровней не зависят от длины
+        void prepare(size_t n) {
+            if (roots.size() >= n) {
+                return;
+            }
+            roots.assign(n, 0);
+            inverse_roots.assign(n, 0);
+            const uint64_t p = field.p;
+            for (size_t len = 1; len < n; len *= 2) {
+                uint64_t w = power_mod(root, (p - 1) / (2 * len), p);
+                uint64_t w_inverse = power_mod(w, p - 2, p);
+                uint64_t step = field.to_montgomery(w);
+                uint64_t step_inverse = field.to_montgomery(w_inverse);
+                uint64_t current = field.to_montgomery(1);
+                uint64_t current_inverse = current;
+                for (size_t j = 0; j < len; ++j) {
+                    roots[len + j] = current;
+                    inverse_roots[len + j] = current_inverse;
+                    current = field.mul(current, step);
+                    current_inverse = field.mul(current_inverse, step_inverse);
+                }
+            }
+        }
+
+        //Прямое преобразование (Джентльмен - Санд): естественный порядок -> бит-реверсный
+        void forward(uint64_t* a, size_t n) const {
+            for (size_t len = n / 2; len >= 1; len /= 2) {
+                const uint64_t* w = roots.data() + len;
+                for (size_t i = 0; i < n; i += 2 * len) {
+                    for (size_t j = 0; j < len; ++j) {
+                        uint64_t u = a[i + j];
+                        uint64_t v = a[i + j + len];
+                        a[i + j] = field.add(u, v);
+                        a[i + j + len] = field.mul(field.sub(u, v), w[j]);
+                    }
+                }
+            }
+        }
+
+        //Обратное преобразование (Кули - Тьюки): бит-реверсный порядок -> естественный, без деления на n
+        void inverse(uint64_t* a, size_t n) const {
+            for (size_t len = 1; len < n; len *= 2) {
+                const uint64_t* w = inverse_roots.data() + len;
+                for (size_t i = 0; i < n; i += 2 * len) {
+                    for (size_t j = 0; j < len; ++j) {
+                        uint64_t u = a[i + j];
+                        uint64_t v = field.mul(a[i + j + len], w[j]);
+                        a[i + j] = field.add(u, v);
+                        a[i + j + len] = field.sub(u, v);
+                    }
+                }
+            }
+        }
+    };
+
+    //Таблицы корней и буферы преобразований переиспользуются между вызовами в пределах потока
+    struct ntt_workspace {
+        transform transforms[3] = { transform(PRIMES[0]), transform(PRIMES[1]), transform(PRIMES[2]) };
+        std::vector<uint64_t> residues[3];
+        std::vector<uint64_t> other;
+    };
+
+    ntt_workspace& workspace() {
+        thread_local ntt_workspace instance;
+        return instance;
+    }
+
+    //Коэффициент многочлена - 64-битный кусок числа
+    constexpr size_t LIMBS_PER_COEFFICIENT = 64 / LIMB_BITS;
+
+    size_t coefficient_count(size_t limbs) {
+        return (limbs + LIMBS_PER_COEFFICIENT - 1) / LIMBS_PER_COEFFICIENT;
+    }
+
+    void load_coefficients(uint64_t* target, size_t n, const limb_t* x, size_t x_size, uint64_t p) {
+        size_t count = coefficient_count(x_size);
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t value = 0;
+            for (size_t k = 0; k < LIMBS_PER_COEFFICIENT; ++k) {
+                size_t index = i * LIMBS_PER_COEFFICIENT + k;
+                if (index < x_size) {
+                    value |= static_cast<uint64_t>(x[index]) << (k * LIMB_BITS % 64);
+                }
+            }
+            target[i] = value % p;
+        }
+        std::fill(target + count, target + n, 0);
+    }
+
+    //Свёртка a и b по модулю одного простого, результат в target (n элементов)
+    void convolve(const transform& t, uint64_t* target, uint64_t* other, size_t n,
+        const limb_t* a, size_t a_size, const limb_t* b, size_t b_size) {
+        const montgomery& field = t.field;
+        load_coefficients(target, n, a, a_size, field.p);
+        t.forward(target, n);
+        if (a == b && a_size == b_size) {
+            //Квадрат: одно прямое преобразование вместо двух
+            for (size_t i = 0; i < n; ++i) {
+                target[i] = field.mul(target[i], target[i]);
+            }
+        }
+        else {
+            load_coefficients(other, n, b, b_size, field.p);
+            t.forward(other, n);
+            for (size_t i = 0; i < n; ++i) {
+                target[i] = field.mul(target[i], other[i]);
+            }
+        }
+        t.inverse(target, n);
+        //Поточечное произведение дало лишний множитель 1/R, обратное преобразование - множитель n
+        uint64_t scale = field.to_montgomery(field.to_montgomery(power_mod(n % field.p, field.p - 2, field.p)));
+        for (size_t i = 0; i < n; ++i) {
+            target[i] = field.mul(target[i], scale);
+        }
+    }
+}
+
+void BigInteger::multiply_ntt(limb_t* result, const limb_t* a, size_t a_size,
+    const limb_t* b, size_t b_size) {
+    const size_t result_size = a_size + b_size;
+    const size_t coefficients = coefficient_count(a_size) + coefficient_count(b_size);
+    size_t n = 1;
+    while (n < coefficients) {
+        n *= 2;
+    }
+    if (n > MAX_TRANSFORM_SIZE) {
+        throw std::length_error("Operands are too large for NTT multiplication");
+    }
+
+    ntt_workspace& space = workspace();
+    if (space.other.size() < n) {
+        space.other.resize(n);
+        for (std::vector<uint64_t>& residue : space.residues) {
+            residue.resize(n);
+        }
+    }
+    for (size_t k = 0; k < 3; ++k) {
+        space.transforms[k].prepare(n);
+        convolve(space.transforms[k], space.residues[k].data(), space.other.data(), n, a, a_size, b, b_size);
+    }
+
+    //Китайская теорема об остатках (схема Гарнера): x = r0 + p0 * t1 + p0 * p1 * t2
+    const montgomery& field1 = space.transforms[1].field;
+    const montgomery& field2 = space.transforms[2].field;
+    const uint64_t p0 = PRIMES[0].modulus;
+    const uint64_t p1 = PRIMES[1].modulus;
+    const uint64_t p2 = PRIMES[2].modulus;
+    const uint64_t p0_inverse_mod_p1 = field1.to_montgomery(power_mod(p0 % p1, p1 - 2, p1));
+    const uint64_t p0_inverse_mod_p2 = field2.to_montgomery(power_mod(p0 % p2, p2 - 2, p2));
+    const uint64_t p1_inverse_mod_p2 = field2.to_montgomery(power_mod(p1 % p2, p2 - 2, p2));
+    const uint128_t p0p1 = (uint128_t)p0 * p1;
+    const uint64_t p0p1_low = static_cast<uint64_t>(p0p1);
+    const uint64_t p0p1_high = static_cast<uint64_t>(p0p1 >> 64);
+
+    constexpr size_t WORDS = 192 / LIMB_BITS;
+    limb_t words[WORDS];
+    std::fill(result, result + result_size, 0);
+    for (size_t i = 0; i + 1 < coefficients; ++i) {
+        uint64_t r0 = space.residues[0][i];
+        uint64_t r1 = space.residues[1][i];
+        uint64_t r2 = space.residues[2][i];
+        //p0 > p1 > p2 и p0 < 2 * p2, поэтому приведение - одно вычитание
+        uint64_t r0_mod_p1 = (r0 >= p1) ? r0 - p1 : r0;
+        uint64_t r0_mod_p2 = (r0 >= p2) ? r0 - p2 : r0;
+        uint64_t t1 = field1.mul(field1.sub(r1, r0_mod_p1), p0_inverse_mod_p1);
+        uint64_t t1_mod_p2 = (t1 >= p2) ? t1 - p2 : t1;
+        uint64_t t2 = field2.mul(field2.sub(r2, r0_mod_p2), p0_inverse_mod_p2);
+        t2 = field2.mul(field2.sub(t2, t1_mod_p2), p1_inverse_mod_p2);
+
+        //192-битная сумма r0 + p0 * t1 + p0p1 * t2 в трёх 64-битных словах
+        uint128_t low = r0 + (uint128_t)p0 * t1;
+        uint128_t middle_low = (uint128_t)p0p1_low * t2;
+        uint128_t middle_high = (uint128_t)p0p1_high * t2;
+        uint128_t acc = (uint128_t)static_cast<uint64_t>(low) + static_cast<uint64_t>(middle_low);
+        uint64_t x[3];
+        x[0] = static_cast<uint64_t>(acc);
+        acc = (acc >> 64) + static_cast<uint64_t>(low >> 64) + static_cast<uint64_t>(middle_low >> 64)
+            + static_cast<uint64_t>(middle_high);
+        x[1] = static_cast<uint64_t>(acc);
+        x[2] = static_cast<uint64_t>(acc >> 64) + static_cast<uint64_t>(middle_high >> 64);
+
+        for (size_t w = 0; w < WORDS; ++w) {
+            words[w] = static_cast<limb_t>(x[w * LIMB_BITS / 64] >> (w * LIMB_BITS % 64));
+        }
+        size_t offset = i * LIMBS_PER_COEFFICIENT;
+        if (offset < result_size) {
+            add_to(result + offset, result_size - offset, words,
+                normalized_size(words, std::min(WORDS, result_size - offset)));
+        }
+    }
+}
@@ -0,0 +1,118 @@
+#include "../include/biginteger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+//---------------------------------------П У Л   Л И М Б О В---------------------------------------------------------
+
+namespace {
+
+    //Классы размеров - степени двойки от 32 байт (4 лимба) до 1 МиБ; блоки крупнее идут мимо пула
+    constexpr unsigned MIN_CLASS_BITS = 5;
+    constexpr unsigned MAX_CLASS_BITS = 20;
+    constexpr size_t CLASS_COUNT = MAX_CLASS_BITS - MIN_CLASS_BITS + 1;
+
+    //Предел кэша одного потока; меняется через BigInteger::set_pool_limit
+    std::atomic<size_t> cache_limit{ size_t(4) << 20 };
+
+    //Номер класса для блока bytes байт (CLASS_COUNT - блок вне пула)
+    size_t size_class(size_t bytes) {
+        const unsigned bits = std::max(MIN_CLASS_BITS, static_cast<unsigned>(std::bit_width(bytes - 1)));
+        return (bits > MAX_CLASS_BITS) ? CLASS_COUNT : bits - MIN_CLASS_BITS;
+    }
+
+    //Освобождённый блок хранит в себе ссылку на следующий свободный блок своего класса
+    struct free_block {
+        free_block* next;
+    };
+
+    struct thread_cache {
+        free_block* lists[CLASS_COUNT] = {};
+        biginteger_pool_statistics statistics;
+
+        ~thread_cache();
+    };
+
+    //Кэш уже уничтожен при выходе из потока: числа, живущие дольше него, освобождаются мимо пула.
+    //Флаг тривиально разрушаем и остаётся доступным до конца потока
+    thread_local bool cache_destroyed = false;
+    thread_local thread_cache cache;
+
+    thread_cache::~thread_cache() {
+        cache_destroyed = true;
+        for (size_t c = 0; c < CLASS_COUNT; ++c) {
+            while (lists[c] != nullptr) {
+                free_block* block = lists[c];
+                lists[c] = block->next;
+                std::pmr::new_delete_resource()->deallocate(block, size_t(1) << (c + MIN_CLASS_BITS));
+            }
+        }
+    }
+
+    //Источник памяти без состояния: блок, выделенный в одном потоке, может вернуться в кэш другого,
+    //поэтому числа свободно передаются между потоками. Сам объект живёт до конца программы
+    class limb_pool_resource : public std::pmr::memory_resource {
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            const size_t c = size_class(bytes);
+            if (c == CLASS_COUNT || alignment > alignof(std::max_align_t)) {
+                return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            }
+            //Блок класса всегда выделяется целиком: его можно вернуть в кэш любого потока
+            const size_t class_bytes = size_t(1) << (c + MIN_CLASS_BITS);
+            if (cache_destroyed) {
+                return std::pmr::new_delete_resource()->allocate(class_bytes);
+            }
+            free_block*& list = cache.lists[c];
+            if (list != nullptr) {
+                free_block* block = list;
+                list = block->next;
+                ++cache.statistics.hits;
+                cache.statistics.cached_bytes -= class_bytes;
+                return block;
+            }
+            ++cache.statistics.misses;
+            return std::pmr::new_delete_resource()->allocate(class_bytes);
+        }
+
+        void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {
+            const size_t c = size_class(bytes);
+            if (c == CLASS_COUNT || alignment > alignof(std::max_align_t)) {
+                std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+                return;
+            }
+            const size_t class_bytes = size_t(1) << (c + MIN_CLASS_BITS);
+            if (cache_destroyed
+                || cache.statistics.cached_bytes + class_bytes > cache_limit.load(std::memory_order_relaxed)) {
+                std::pmr::new_delete_resource()->deallocate(pointer, class_bytes);
+                return;
+            }
+            free_block* block = static_cast<free_block*>(pointer);
+            block->next = cache.lists[c];
+            cache.lists[c] = block;
+            cache.statistics.cached_bytes += class_bytes;
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+}
+
+std::pmr::memory_resource* BigInteger::limb_pool() {
+    //Пул не разрушается: статические числа могут освобождать память и после выхода из main
+    alignas(limb_pool_resource) static unsigned char storage[sizeof(limb_pool_resource)];
+    static limb_pool_resource* const pool = new (storage) limb_pool_resource;
+    return pool;
+}
+
+biginteger_pool_statistics BigInteger::pool_statistics() {
+    return cache_destroyed ? biginteger_pool_statistics{} : cache.statistics;
+}
+
+void BigInteger::set_pool_limit(size_t bytes) {
+    cache_limit.store(bytes, std::memory_order_relaxed);
+}
@@ -0,0 +1,208 @@
+#include "../include/biginteger.hpp"
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+
+//---------------------------------------К О Р Н И---------------------------------------------------------
+
+namespace {
+
+    __extension__ typedef unsigned __int128 uint128_t;
+
+    //Числа до 124 бит корень извлекается в машинной арифметике
+    constexpr size_t SMALL_ROOT_BITS = 124;
+
+    uint128_t to_uint128(const BigInteger& value) {
+        uint32_t words[4];
+        uint128_t result = 0;
+        for (size_t i = value.get_data(words); i-- > 0;) {
+            result = (result << 32) | words[i];
+        }
+        return result;
+    }
+
+    BigInteger from_uint128(uint128_t value) {
+        BigInteger result(static_cast<unsigned long long>(value >> 64));
+        result <<= 64;
+        result += BigInteger(static_cast<unsigned long long>(value));
+        return result;
+    }
+
+    //Корень из числа меньше 2^124: оценка в double, шаг Ньютона и поправка на единицу
+    uint64_t small_isqrt(uint128_t n) {
+        if (n == 0) {
+            return 0;
+        }
+        uint128_t x = static_cast<uint128_t>(std::sqrt(static_cast<double>(n)));
+        x = (x + n / x) / 2;
+        while (x * x > n) {
+            --x;
+        }
+        while ((x + 1) * (x + 1) <= n) {
+            ++x;
+        }
+        return static_cast<uint64_t>(x);
+    }
+
+    // x mod 2^bits для x >= 0
+    BigInteger low_bits(const BigInteger& x, size_t bits) {
+        return x & ((BigInteger(1) << bits) - 1);
+    }
+
+    //Корень с остатком по Циммерману (Karatsuba square root): n дополняется до 4h бит со старшей четвертью
+    //не меньше 2^(h-2), корень из старшей половины уточняется одним делением вдвое меньшей длины
+    void sqrt_remainder(const BigInteger& n, BigInteger& root, BigInteger& remainder) {
+        const size_t bits = n.bit_length();
+        if (bits <= SMALL_ROOT_BITS) {
+            const uint128_t value = to_uint128(n);
+            const uint64_t s = small_isqrt(value);
+            root = BigInteger(static_cast<unsigned long long>(s));
+            remainder = from_uint128(value - uint128_t(s) * s);
+            return;
+        }
+        const size_t h = (bits + 3) / 4;
+        const size_t shift = (4 * h - bits) / 2;
+        const BigInteger m = n << (2 * shift);
+        BigInteger high_root;
+        BigInteger high_remainder;
+        sqrt_remainder(m >> (2 * h), high_root, high_remainder);
+        BigInteger quotient;
+        BigInteger rest;
+        BigInteger::divmod((high_remainder << h) + low_bits(m >> h, h), high_root << 1, quotient, rest);
+        root = (high_root << h) + quotient;
+        remainder = (rest << h) + low_bits(m, h) - quotient.square();
+        while (remainder.get_is_negative()) {
+            remainder += root;
+            --root;
+            remainder += root;
+        }
+        if (shift != 0) {
+            root >>= shift;
+            remainder = n - root.square();
+        }
+    }
+
+    BigInteger power(const BigInteger& base, unsigned long exponent) {
+        BigInteger result = 1;
+        for (int bit = std::bit_width(exponent) - 1; bit >= 0; --bit) {
+            result = result.square();
+            if ((exponent >> bit) & 1) {
+                result *= base;
+            }
+        }
+        return result;
+    }
+
+    //floor(n^(1/k)) для n >= 0, k >= 3: корень из n / 2^(k s) даёт половину бит, затем Ньютон сверху
+    //x' = ((k - 1) x + n / x^(k-1)) / k убывает до точного значения за один-два шага
+    BigInteger nth_root(const BigInteger& n, unsigned long k) {
+        //0 < n < 2^k: корень равен 1, а power(x + 1, k) построил бы 2^k целиком
+        if (k >= n.bit_length()) {
+            return BigInteger(n.isZero() ? 0 : 1);
+        }
+        const size_t root_bits = n.bit_length() / k + 1;
+        if (root_bits <= 52) {
+            //Оценка в double по старшим битам и точная поправка
+            const size_t bits = n.bit_length();
+            const size_t drop = bits > 64 ? bits - 64 : 0;
+            const double top = static_cast<double>(to_uint128(n >> drop));
+            const double estimate = std::pow(top, 1.0 / static_cast<double>(k)) *
+                std::exp2(static_cast<double>(drop) / static_cast<double>(k));
+            BigInteger x(static_cast<unsigned long long>(estimate));
+            while (x > 0 && power(x, k) > n) {
+                --x;
+            }
+            while (power(x + 1, k) <= n) {
+                ++x;
+            }
+            return x;
+        }
+        const size_t half = root_bits / 2;
+        BigInteger x = (nth_root(n >> (k * half), k) + 1) << half;
+        for (;;) {
+            BigInteger next = (x * (k - 1) + n / power(x, k - 1)) / k;
+            if (next >= x) {
+                return x;
+            }
+            x = std::move(next);
+        }
+    }
+
+    //Маска квадратичных вычетов по модулю m <= 64
+    constexpr uint64_t square_residues(unsigned m) {
+        uint64_t mask = 0;
+        for (unsigned i = 0; i < m; ++i) {
+            mask |= uint64_t(1) << (i * i % m);
+        }
+        return mask;
+    }
+
+    constexpr unsigned RESIDUE_MODULI[] = { 63, 11, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53 };
+    constexpr uint64_t RESIDUE_MASKS[] = {
+        square_residues(63), square_residues(11), square_residues(17), square_residues(19),
+        square_residues(23), square_residues(29), square_residues(31), square_residues(37),
+        square_residues(41), square_residues(43), square_residues(47), square_residues(53) };
+
+    //Произведение RESIDUE_MODULI < 2^64: один остаток от деления на лимб проверяет все модули
+    constexpr uint64_t residue_product() {
+        uint64_t product = 1;
+        for (unsigned m : RESIDUE_MODULI) {
+            product *= m;
+        }
+        return product;
+    }
+}
+
+BigInteger isqrt(const BigInteger& value) {
+    BigInteger root;
+    BigInteger remainder;
+    sqrtrem(value, root, remainder);
+    return root;
+}
+
+void sqrtrem(const BigInteger& value, BigInteger& root, BigInteger& remainder) {
+    if (value.get_is_negative()) {
+        throw std::invalid_argument("Square root of a negative number");
+    }
+    sqrt_remainder(value, root, remainder);
+}
+
+BigInteger iroot(const BigInteger& value, unsigned long k) {
+    if (k == 0) {
+        throw std::invalid_argument("Zeroth root");
+    }
+    if (value.get_is_negative() && k % 2 == 0) {
+        throw std::invalid_argument("Even root of a negative number");
+    }
+    if (k == 1 || value.isZero()) {
+        return value;
+    }
+    //Корень отрицательного числа усекается к нулю, как в GMP
+    const BigInteger magnitude = value.abs();
+    BigInteger root = k == 2 ? isqrt(magnitude) : nth_root(magnitude, k);
+    return value.get_is_negative() ? -root : root;
+}
+
+bool is_perfect_square(const BigInteger& value) {
+    if (value.get_is_negative()) {
+        return false;
+    }
+    //Квадраты по модулю 64 принимают 12 значений из 64; ещё 12 модулей пропускают менее 10^(-4) неквадратов
+    uint32_t low_word[1];
+    value.get_data(low_word);
+    if (((square_residues(64) >> (low_word[0] & 63)) & 1) == 0) {
+        return false;
+    }
+    const uint64_t residue = to_uint128(value % BigInteger(static_cast<unsigned long long>(residue_product())));
+    for (size_t i = 0; i < std::size(RESIDUE_MODULI); ++i) {
+        if (((RESIDUE_MASKS[i] >> (residue % RESIDUE_MODULI[i])) & 1) == 0) {
+            return false;
+        }
+    }
+    BigInteger root;
+    BigInteger remainder;
+    sqrtrem(value, root, remainder);
+    return remainder.isZero();
+}
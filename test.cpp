@@ -1,5 +1,8 @@
+#include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <memory_resource>
+#include <vector>
 #include "include/biginteger.hpp"
 
 int test() {
@@ -226,10 +229,930 @@ int test() {
     assert(moved == 99);
     assert(temp.get_size() == 0 || temp.isZero());
 
+    // ================== INLINE STORAGE TESTS ==================
+    BigInteger word(-9223372036854775807LL - 1);
+    assert(word.get_size() == 2 && to_string(word) == "-9223372036854775808");
+    BigInteger grown = word;
+    grown *= word;
+    grown *= word;  // 6 лимбов: переход из встроенного буфера в кучу
+    assert(to_string(grown) == "-784637716923335095479473677900958302012794430558004314112");
+    grown /= word;
+    grown /= word;  // обратно в 2 лимба, память не перевыделяется
+    assert(grown == word && grown.get_size() == 2);
+    BigInteger heap_moved(std::move(grown));
+    assert(heap_moved == word && grown.isZero());
+    grown = heap_moved;
+    heap_moved = std::move(heap_moved);
+    heap_moved += heap_moved;
+    assert(heap_moved == word * 2 && grown == word);
+    BigInteger inline_moved(123);
+    grown = std::move(inline_moved);
+    assert(grown == 123 && inline_moved.isZero());
+
+    // ================== LIMB EXPORT TESTS ==================
+    BigInteger two_words(4294967296ULL);
+    assert(two_words.get_size() == 2 && two_words.get_data()[0] == 0 && two_words.get_data()[1] == 1);
+    BigInteger three_words = BigInteger(4294967296ULL) * BigInteger(4294967296ULL);
+    assert(three_words.get_size() == 3 && three_words.get_data()[2] == 1);
+    assert(BigInteger(7).get_size() == 1 && BigInteger(-7).get_data()[0] == 7);
+    BigInteger all_ones("ffffffffffffffffffffffffffffffff", biginteger_base::hex);
+    assert(all_ones.get_size() == 4 && all_ones.get_data()[3] == 4294967295U);
+    [[maybe_unused]] uint32_t low_words[3] = { 7, 7, 7 };
+    assert(three_words.get_data(low_words) == 3 && low_words[0] == 0 && low_words[1] == 0 && low_words[2] == 1);
+    assert(all_ones.get_data(std::span<uint32_t>(low_words, 2)) == 2 && low_words[1] == 4294967295U && low_words[2] == 1);
+    assert(BigInteger(0).get_data().size() == 1 && BigInteger(0).get_data()[0] == 0);
+    assert(to_string(all_ones / 3) == "113427455640312821154458202477256070485" && all_ones % 7 == 3);
+    BigInteger power_with_tail = BigInteger("1606938044258990275541962092341162602522202993782792835301376") + 12345;
+    assert(to_string(power_with_tail / 1000000007) == "1606938033010424044468993781058206135114760047979472");
+    assert(power_with_tail % 1000000007 == 499457417);
+
+    // ================== CAPACITY TESTS ==================
+    BigInteger running;
+    running.reserve(8);
+    assert(running.get_capacity() == 8 && running.isZero());
+    for (int i = 1; i <= 100000; ++i) {
+        running += BigInteger(i) * 4294967295U;
+        running -= (i % 3 == 0) ? running : BigInteger(0);
+    }
+    assert(running.get_capacity() == 8);
+    BigInteger accumulated(4294967295U);
+    for (int i = 0; i < 20; ++i) {
+        accumulated *= 4294967295U;
+        accumulated += accumulated;
+    }
+    assert(accumulated.get_capacity() >= accumulated.get_size());
+    BigInteger expected_power(4294967295U);
+    for (int i = 0; i < 20; ++i) {
+        expected_power *= 4294967295U;
+        expected_power *= 2;
+    }
+    assert(accumulated == expected_power);
+    accumulated -= accumulated;
+    assert(accumulated.isZero() && !accumulated.get_is_negative());
+    accumulated.shrink_to_fit();
+    assert(accumulated.get_capacity() == 4);
+    BigInteger shrinking = expected_power;
+    shrinking.reserve(100);
+    shrinking.shrink_to_fit();
+    assert(shrinking.get_capacity() == shrinking.get_size() && shrinking == expected_power);
+    assert(BigInteger(5) - BigInteger(-7) == 12 && BigInteger(-5) - BigInteger(-7) == 2);
+
     // ================== EQUALITY TESTS ==================
     assert(BigInteger("123456789") == BigInteger(123456789));
     assert(BigInteger("0") == BigInteger(0));
 
+    // ================== FAST MULTIPLICATION TESTS ==================
+    // 99...9 (n девяток) в квадрате = 9...9 8 0...0 1
+    std::string nines(2000, '9');
+    std::string nines_square = std::string(1999, '9') + "8" + std::string(1999, '0') + "1";
+    biginteger_thresholds saved_thresholds = BigInteger::thresholds();
+    BigInteger::thresholds() = { 4, 16, 32 };
+    assert(to_string(BigInteger(nines) * BigInteger(nines)) == nines_square);
+    BigInteger::thresholds() = { 4, 16, 1000000 };
+    assert(to_string(BigInteger(nines) * BigInteger(nines)) == nines_square);
+    BigInteger::thresholds() = { 4, 1000000, 1000000 };
+    assert(to_string(BigInteger(nines) * BigInteger(nines)) == nines_square);
+    BigInteger::thresholds() = { 4, 16, 32, 64 };
+    assert(to_string(BigInteger(nines) * BigInteger(nines)) == nines_square);
+
+    // Сравнение со столбиком на псевдослучайных числах разной длины (в т.ч. несбалансированных)
+    uint32_t seed = 12345;
+    auto random_hex = [&seed](size_t digits) {
+        const char alphabet[] = "0123456789ABCDEF";
+        std::string result = "1";
+        for (size_t i = 1; i < digits; ++i) {
+            seed = seed * 1103515245 + 12345;
+            result += alphabet[(seed >> 16) & 15];
+        }
+        return BigInteger(result, biginteger_base::hex);
+    };
+    const size_t lengths[][2] = { {300, 300}, {1000, 700}, {1600, 900}, {2500, 200}, {700, 650}, {1200, 1190} };
+    for (const auto& length : lengths) {
+        BigInteger left = random_hex(length[0]);
+        BigInteger right = -random_hex(length[1]);
+        BigInteger::thresholds() = { 1000000, 1000000, 1000000, 1000000 };
+        BigInteger expected = left * right;
+        BigInteger::thresholds() = { 4, 16, 32, 64 };
+        assert(left * right == expected);
+        BigInteger::thresholds() = { 4, 16, 32 };
+        assert(left * right == expected);
+        assert(right * left == expected);
+        BigInteger::thresholds() = { 4, 16, 1000000 };
+        assert(left * right == expected);
+        BigInteger::thresholds() = { 4, 1000000, 1000000 };
+        assert(left * right == expected);
+    }
+    BigInteger::thresholds() = saved_thresholds;
+
+    // ================== DIVMOD TESTS ==================
+    BigInteger quot, rem;
+    BigInteger::divmod(BigInteger(-100), BigInteger(7), quot, rem);
+    assert(quot == -14 && rem == -2);
+    BigInteger::divmod(BigInteger(100), BigInteger(-7), quot, rem);
+    assert(quot == -14 && rem == 2);
+    BigInteger::divmod(BigInteger(5), BigInteger(7), quot, rem);
+    assert(quot == 0 && rem == 5);
+    // (10^n - 1)^2 / (10^n - 1) = 10^n - 1 без остатка
+    BigInteger::divmod(BigInteger(nines_square), BigInteger(nines), quot, rem);
+    assert(to_string(quot) == nines && rem == 0);
+    // q * b + r == a и |r| < |b|; делители с лимбами 0xFFFFFFFF и 0x80000000 проверяют коррекцию цифры
+    const char* divisors[] = { "FFFFFFFFFFFFFFFFFFFFFFFF", "800000000000000000000001", "1FFFFFFFF00000000" };
+    for (const char* text : divisors) {
+        BigInteger b(text, biginteger_base::hex);
+        BigInteger a = random_hex(400);
+        BigInteger::divmod(a, b, quot, rem);
+        assert(quot * b + rem == a);
+        assert(rem.abs() < b);
+        assert(a / b == quot && a % b == rem);
+    }
+    for (size_t length = 9; length < 300; length += 37) {
+        BigInteger a = -random_hex(length * 3);
+        BigInteger b = random_hex(length);
+        BigInteger::divmod(a, b, quot, rem);
+        assert(quot * b + rem == a);
+        assert(rem.abs() < b && (rem.isZero() || rem.get_is_negative()));
+    }
+    // Бурникель - Циглер и деление через обратную величину Ньютона против столбика
+    for (size_t length = 300; length <= 1500; length += 400) {
+        BigInteger a = random_hex(2 * length + 17);
+        BigInteger b = -random_hex(length);
+        BigInteger::thresholds() = { 32, 400, 1200, 5000, 1000000, 1000000 };
+        BigInteger expected_quotient, expected_remainder;
+        BigInteger::divmod(a, b, expected_quotient, expected_remainder);
+        assert(expected_quotient * b + expected_remainder == a);
+        BigInteger::thresholds() = { 32, 400, 1200, 5000, 8, 1000000 };
+        BigInteger::divmod(a, b, quot, rem);
+        assert(quot == expected_quotient && rem == expected_remainder);
+        // Рекурсия с порогом включения выше длины блока, на которой она переходит к столбику
+        BigInteger::thresholds().burnikel_ziegler = 200;
+        BigInteger::thresholds().burnikel_ziegler_block = 24;
+        BigInteger::divmod(a, b, quot, rem);
+        assert(quot == expected_quotient && rem == expected_remainder);
+        BigInteger::thresholds() = { 32, 400, 1200, 5000, 8, 64 };
+        BigInteger::divmod(a, b, quot, rem);
+        assert(quot == expected_quotient && rem == expected_remainder);
+    }
+    BigInteger::thresholds() = saved_thresholds;
+    BigInteger::divmod(BigInteger(nines_square), BigInteger(nines), quot, rem);
+    assert(to_string(quot) == nines && rem == 0);
+
+    BigInteger aliased("123456789012345678901234567890");
+    BigInteger::divmod(aliased, BigInteger("987654321"), aliased, rem);
+    assert(to_string(aliased) == "124999998873437499901" && to_string(rem) == "574845669");
+
+    // ================== DECIMAL PARSING TESTS ==================
+    BigInteger power_of_ten(1);
+    for (size_t i = 0; i < nines.size(); ++i) {
+        power_of_ten *= 10;
+    }
+    for (size_t threshold : { 1, 3, 40 }) {
+        BigInteger::thresholds().radix_conversion = threshold;
+        assert(BigInteger(nines) + 1 == power_of_ten);
+        assert(BigInteger("1" + std::string(nines.size(), '0')) == power_of_ten);
+        assert(BigInteger("-" + nines_square) == -(power_of_ten - 1) * (power_of_ten - 1));
+    }
+    BigInteger::thresholds() = saved_thresholds;
+    assert(BigInteger("-000000000123") == -123 && BigInteger("1000000000") == 1000000000);
+    assert(BigInteger("18446744073709551616") == BigInteger("10000000000000000", biginteger_base::hex));
+    try {
+        BigInteger invalid(std::string(30, '1') + "x");
+        assert(false);
+    }
+    catch (const std::invalid_argument&) {
+    }
+
+    // ================== DECIMAL OUTPUT TESTS ==================
+    for (size_t threshold : { 2, 5, 40 }) {
+        BigInteger::thresholds().radix_conversion = threshold;
+        assert(to_string(power_of_ten) == "1" + std::string(nines.size(), '0'));
+        assert(to_string(power_of_ten + 7) == "1" + std::string(nines.size() - 1, '0') + "7");
+        assert(to_string(-(power_of_ten - 1) * (power_of_ten - 1)) == "-" + nines_square);
+        BigInteger value = random_hex(1000);
+        assert(BigInteger(to_string(value)) == value);
+    }
+    BigInteger::thresholds() = saved_thresholds;
+    assert(to_string(BigInteger(1000000000)) == "1000000000" && to_string(BigInteger(-999999999)) == "-999999999");
+    assert(to_string(BigInteger(18446744073709551615ULL)) == "18446744073709551615");
+
+    // ================== POWER OF TWO RADIX TESTS ==================
+    BigInteger sevens(std::string(60, '7'));
+    const std::string sevens_oct = "1737203534457203032516714655743157000322124156061616161616161616161";
+    const std::string sevens_bin = "1111011111010000011101011100100101111010000011000011010101001110111001100110"
+        "101101111100011001101111000000000011010010001010100001101110000110001110001110001110001110001110001110001110001110001110001";
+    assert(to_hex(sevens) == "7BE83AE4BD061AA77335BE337801A454370C71C71C71C71C71");
+    assert(to_string(-sevens, biginteger_base::oct) == "-" + sevens_oct);
+    assert(to_string(sevens, biginteger_base::bin) == sevens_bin);
+    assert(BigInteger(sevens_oct, biginteger_base::oct) == sevens);
+    assert(BigInteger("-" + sevens_bin, biginteger_base::bin) == -sevens);
+    assert(BigInteger("7be83ae4bd061AA77335BE337801A454370C71C71C71C71C71", biginteger_base::hex) == sevens);
+    assert(to_string(BigInteger(0), biginteger_base::bin) == "0" && to_string(BigInteger(5), biginteger_base::oct) == "5");
+    BigInteger long_hex = random_hex(5000);
+    assert(BigInteger(to_hex(long_hex), biginteger_base::hex) == long_hex);
+    assert(BigInteger(to_string(long_hex, biginteger_base::oct), biginteger_base::oct) == long_hex);
+    const char* invalid_digits[][2] = { { "102", "Invalid binary digit" }, { "778", "Invalid octal digit" }, { "FG", "Invalid hex digit" } };
+    const biginteger_base invalid_bases[] = { biginteger_base::bin, biginteger_base::oct, biginteger_base::hex };
+    for (size_t i = 0; i < 3; ++i) {
+        try {
+            BigInteger invalid(invalid_digits[i][0], invalid_bases[i]);
+            assert(false);
+        }
+        catch (const std::invalid_argument& error) {
+            assert(std::string(error.what()) == invalid_digits[i][1]);
+        }
+    }
+
+    // ================== TO_CHARS / FROM_CHARS TESTS ==================
+    char buffer[64];
+    BigInteger two_100 = BigInteger(1ULL << 50) * BigInteger(1ULL << 50);
+    std::to_chars_result written = to_chars(buffer, buffer + sizeof(buffer), -two_100, 36);
+    assert(written.ec == std::errc() && std::string(buffer, written.ptr) == "-3ewfdnca0n6ld1ggvfgg");
+    BigInteger parsed;
+    std::from_chars_result read = from_chars(buffer, written.ptr, parsed, 36);
+    assert(read.ec == std::errc() && read.ptr == written.ptr && parsed == -two_100);
+    // При value_too_large содержимое буфера не определено
+    assert(to_chars(buffer, buffer + 21, -two_100, 36).ec == std::errc());
+    assert(to_chars(buffer, buffer + 20, -two_100, 36).ec == std::errc::value_too_large);
+    const std::string three_50 = "1" + std::string(50, '0');
+    read = from_chars(three_50.data(), three_50.data() + three_50.size(), parsed, 3);
+    assert(read.ec == std::errc() && size_in_base(parsed, 3) - 51 <= 1);
+    written = to_chars(buffer, buffer + sizeof(buffer), parsed, 3);
+    assert(std::string(buffer, written.ptr) == three_50);
+    written = to_chars(buffer, buffer + sizeof(buffer), BigInteger(std::string(30, '9')), 7);
+    assert(std::string(buffer, written.ptr) == "243230604464041356413054436032064450");
+    const std::string partial = "-0012abc";
+    read = from_chars(partial.data(), partial.data() + partial.size(), parsed);
+    assert(read.ec == std::errc() && read.ptr == partial.data() + 5 && parsed == -12);
+    const std::string no_digits = "-x";
+    read = from_chars(no_digits.data(), no_digits.data() + no_digits.size(), parsed);
+    assert(read.ec == std::errc::invalid_argument && read.ptr == no_digits.data() && parsed == -12);
+    read = from_chars(partial.data(), partial.data() + 3, parsed);
+    assert(parsed == 0 && !parsed.get_is_negative());
+    for (size_t threshold : { 2, 40 }) {
+        BigInteger::thresholds().radix_conversion = threshold;
+        for (int base : { 3, 10, 16, 36 }) {
+            BigInteger value = -random_hex(700);
+            std::string text(size_in_base(value, base) + 1, ' ');
+            written = to_chars(text.data(), text.data() + text.size(), value, base);
+            assert(written.ec == std::errc() && size_t(text.data() + text.size() - written.ptr) <= 1);
+            read = from_chars(text.data(), written.ptr, parsed, base);
+            assert(read.ptr == written.ptr && parsed == value);
+        }
+    }
+    // Буфер точной длины принимается, на символ короче - value_too_large; числа у степеней основания
+    // проверяют случай, когда оценка size_in_base длиннее числа
+    for (size_t threshold : { 2, 40 }) {
+        BigInteger::thresholds().radix_conversion = threshold;
+        for (int base : { 2, 3, 10, 16, 36 }) {
+            BigInteger power = 1;
+            for (int i = 0; i < 60; ++i) {
+                power *= base;
+            }
+            for (const BigInteger& value : { BigInteger(0), BigInteger(base - 1), power, power - 1, -power,
+                     1 - power, random_hex(40), -random_hex(700) }) {
+                std::string text(size_in_base(value, base) + 1, ' ');
+                written = to_chars(text.data(), text.data() + text.size(), value, base);
+                const size_t length = static_cast<size_t>(written.ptr - text.data());
+                std::string tight(length, ' ');
+                written = to_chars(tight.data(), tight.data() + length, value, base);
+                assert(written.ec == std::errc() && written.ptr == tight.data() + length);
+                assert(tight == text.substr(0, length));
+                written = to_chars(tight.data(), tight.data() + length - 1, value, base);
+                assert(written.ec == std::errc::value_too_large && written.ptr == tight.data() + length - 1);
+            }
+        }
+    }
+    BigInteger::thresholds() = saved_thresholds;
+#if defined(__cpp_lib_format)
+    const BigInteger formatted = -random_hex(300);
+    assert(std::format("{}", -two_100) == "-1267650600228229401496703205376" && std::format("{:d}", BigInteger(0)) == "0");
+    assert(std::format("{:x}|{:X}|{:o}|{:b}", BigInteger(255), BigInteger(-255), BigInteger(8), BigInteger(5)) == "ff|-FF|10|101");
+    assert(std::format("{}", formatted) == to_string(formatted) && std::format("{:X}", formatted) == to_hex(formatted));
+    assert(std::format("{:>6}|{:<6}|{:^7}", BigInteger(-42), BigInteger(42), BigInteger(42)) == "   -42|42    |  42   ");
+    assert(std::format("{:*^8x}|{:4}|{:2}", BigInteger(255), BigInteger(7), BigInteger(-1000)) == "***ff***|   7|-1000");
+    assert(std::format("{:>40}", -two_100) == std::string(8, ' ') + "-1267650600228229401496703205376");
+    bool bad_width_rejected = false;
+    try { (void)std::vformat("{:08}", std::make_format_args(two_100)); } catch (const std::format_error&) { bad_width_rejected = true; }
+    assert(bad_width_rejected);
+#endif
+
+    // ================== SQUARING TESTS ==================
+    assert(BigInteger(0).square() == 0 && BigInteger(-7).square() == 49);
+    assert(to_string(BigInteger(nines).square()) == nines_square);
+    for (size_t length : { 1, 17, 33, 200, 900, 2600 }) {
+        BigInteger x = -random_hex(length);
+        BigInteger copy = x;
+        BigInteger::thresholds() = { 1000000, 1000000, 1000000, 1000000 };
+        BigInteger::thresholds().karatsuba_square = 1000000;
+        const BigInteger expected = x * copy;
+        assert(x.square() == expected && !expected.get_is_negative());
+        // Пороги снижены, чтобы квадрат прошёл через Карацубу, Тоом-Кука и NTT
+        BigInteger::thresholds() = { 4, 16, 32, 64 };
+        BigInteger::thresholds().karatsuba_square = 4;
+        assert(x.square() == expected && x * x == expected && x * copy == expected);
+        BigInteger::thresholds() = { 4, 16, 1000000 };
+        BigInteger::thresholds().karatsuba_square = 6;
+        assert(x.square() == expected);
+        copy *= copy;
+        assert(copy == expected);
+    }
+    BigInteger::thresholds() = saved_thresholds;
+
+    // ================== FUSED OPERATION TESTS ==================
+    BigInteger fused = 10;
+    fused.addmul(3, 4);
+    assert(fused == 22);
+    fused.submul(-5, 6);
+    assert(fused == 52);
+    fused.submul(13, 4);
+    assert(fused == 0 && !fused.get_is_negative());
+    fused.addmul(-7, 0);
+    assert(fused == 0 && mul_add(-3, 5, 15) == 0 && mul_add(0, 5, -2) == -2);
+    for (size_t length : { 3, 16, 40, 500 }) {
+        const BigInteger a = random_hex(length);
+        const BigInteger b = -random_hex(length / 2 + 1);
+        const BigInteger c = random_hex(length + 7);
+        const BigInteger d = random_hex(1);
+        const BigInteger e = -random_hex(2 * length);
+        BigInteger expression = mul_add(a, b, -e);
+        expression.addmul(c, d);
+        assert(expression == a * b + c * d - e);
+        BigInteger accumulator = e;
+        accumulator.addmul(a, d).submul(b, c).addmul(c, c);
+        assert(accumulator == e + a * d - b * c + c * c);
+        // Совпадение аргументов с результатом
+        BigInteger self = a;
+        self.addmul(self, self);
+        assert(self == a + a * a);
+        self = b;
+        self.submul(self, d);
+        assert(self == b - b * d);
+        assert(a * b == b * a && a * a == a.square());
+    }
+
+    // ================== RVALUE OPERATOR TESTS ==================
+    // Источник памяти, считающий выделения (нужен и тестам источников памяти ниже)
+    struct counting_resource : std::pmr::memory_resource {
+        size_t allocations = 0;
+        size_t live_bytes = 0;
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            ++allocations;
+            live_bytes += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {
+            live_bytes -= bytes;
+            std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+    counting_resource counting;
+    for (size_t length : { 1, 5, 40 }) {
+        const BigInteger a = random_hex(length + 3);
+        const BigInteger b = -random_hex(length);
+        const BigInteger sum = a + b;
+        const BigInteger difference = a - b;
+        assert(BigInteger(a) + b == sum && a + BigInteger(b) == sum && BigInteger(a) + BigInteger(b) == sum);
+        assert(BigInteger(a) - b == difference && a - BigInteger(b) == difference);
+        assert(BigInteger(b) - a == -difference && BigInteger(a) - BigInteger(b) == difference);
+        assert(BigInteger(a) * b == a * b && a * BigInteger(b) == a * b && BigInteger(b) * BigInteger(a) == a * b);
+        assert(BigInteger(a) / b == a / b && BigInteger(a) % b == a % b);
+        for ([[maybe_unused]] const BigInteger& c : { b, -b, a }) {
+            assert((BigInteger(a) & c) == (a & c) && (c & BigInteger(a)) == (a & c));
+            assert((BigInteger(a) | c) == (a | c) && (c | BigInteger(a)) == (a | c));
+            assert((BigInteger(a) ^ c) == (a ^ c) && (BigInteger(c) ^ BigInteger(a)) == (a ^ c));
+        }
+        assert((BigInteger(b) << 77) == (b << 77) && (BigInteger(b) >> 77) == (b >> 77));
+        assert(-BigInteger(b) == -b && -BigInteger(0) == 0 && !(-BigInteger(0)).get_is_negative());
+        // Выражение с перемещёнными операндами и совпадающие аргументы
+        BigInteger moved = a;
+        assert(std::move(moved) - a == 0);
+        moved = a;
+        assert(a - std::move(moved) == 0);
+        moved = b;
+        assert((std::move(moved) ^ b) == 0);
+    }
+    // Результат остаётся в буфере истекающего операнда, если памяти хватает: новых выделений нет
+    {
+        const BigInteger original = random_hex(64);
+        const BigInteger addend = random_hex(60);
+        const BigInteger minuend = random_hex(3);
+        const BigInteger mask = random_hex(70);
+        const BigInteger expected = (-(minuend - (original + addend)) << 200) & mask;
+        const MemoryResourceScope scope(&counting);
+        BigInteger stolen = original;
+        stolen.reserve(40);
+        [[maybe_unused]] const size_t before = counting.allocations;
+        BigInteger stealer = std::move(stolen) + addend;
+        stealer = -(minuend - std::move(stealer));
+        stealer = (std::move(stealer) << 200) & mask;
+        assert(counting.allocations == before && stealer == expected);
+    }
+
+    // ================== MIXED INTEGER TESTS ==================
+    const int64_t int64_min = INT64_MIN;
+    const uint64_t uint64_max = UINT64_MAX;
+    assert(BigInteger(0) == 0 && BigInteger(0) == 0U && 0 == BigInteger(0) && BigInteger(-5) != 5);
+    assert(BigInteger(int64_min) == int64_min && BigInteger(uint64_max) == uint64_max && BigInteger(-1) != uint64_max);
+    assert(BigInteger(-3) < 2 && 2 > BigInteger(-3) && BigInteger(7) >= 7U && random_hex(20) > uint64_max);
+    assert(-random_hex(20) < int64_min && BigInteger(int64_min) <= int64_min && BigInteger(-7) > int64_min);
+    assert(BigInteger(0).sign() == 0 && BigInteger(-9).sign() == -1 && random_hex(30).sign() == 1);
+    assert((-BigInteger(0)).isZero() && !BigInteger(int64_min).isZero());
+    for (size_t length : { 1, 17, 33, 120 }) {
+        const BigInteger x = (length % 2 == 0) ? random_hex(length) : -random_hex(length);
+        for (int64_t n : { int64_t(0), int64_t(1), int64_t(-1), int64_t(10), int64_t(-977), int64_min, INT64_MAX }) {
+            const BigInteger big_n = n;
+            assert(x + n == x + big_n && n + x == x + big_n && x - n == x - big_n && n - x == big_n - x);
+            assert(x * n == x * big_n && n * x == x * big_n && BigInteger(x) * n == x * big_n);
+            if (n != 0) {
+                assert(x / n == x / big_n && x % n == x % big_n && BigInteger(x) % n == x % big_n);
+            }
+            BigInteger compound = x;
+            compound += n;
+            compound *= n;
+            compound -= n;
+            assert(compound == (x + big_n) * big_n - big_n);
+            assert((x < n) == (x < big_n) && (x == n) == (x == big_n) && (n <= x) == (big_n <= x));
+        }
+        BigInteger compound = x;
+        compound /= uint64_max;
+        assert(compound == x / BigInteger(uint64_max));
+        compound = x;
+        compound %= 1000000007U;
+        assert(compound == x % BigInteger(1000000007U));
+        assert(x * uint64_max == x * BigInteger(uint64_max) && x - uint64_max == x - BigInteger(uint64_max));
+    }
+    BigInteger counter = -2;
+    for (int i = 0; i < 5; ++i) {
+        counter += 1;
+    }
+    assert(counter == 3 && counter * 0 == 0 && !(counter * 0).get_is_negative() && (-counter) % 3 == 0);
+    assert((BigInteger(-7) % 3).get_is_negative() && BigInteger(-7) / 2 == -3 && !(BigInteger(-1) / 2).get_is_negative());
+    try {
+        counter /= 0;
+        assert(false);
+    }
+    catch (const std::invalid_argument&) {
+    }
+    try {
+        counter % 0U;
+        assert(false);
+    }
+    catch (const std::invalid_argument&) {
+    }
+
+    // bool и символьные типы не попадают в шаблоны (std::cmp_less их не принимает) и преобразуются в BigInteger
+    static_assert(!biginteger_small_integer<bool> && !biginteger_small_integer<char> && !biginteger_small_integer<char32_t>);
+    static_assert(biginteger_small_integer<signed char> && biginteger_small_integer<unsigned char>);
+    const bool flag = true;
+    BigInteger flagged = 41;
+    flagged += flag;
+    flagged *= true;
+    assert(flagged == 42 && flagged * false == 0 && flagged - flag == 41 && flag + flagged == 43);
+    assert(BigInteger(97) == 'a' && 'b' > BigInteger(97) && BigInteger(1) * u'\x10' == 16 && BigInteger(200) % L'\x07' == 4);
+
+    // ================== THREE-WAY COMPARISON TESTS ==================
+    const BigInteger low_differs = (BigInteger(1) << 300) + 5;
+    const BigInteger low_differs_next = low_differs + 1;
+    assert((low_differs <=> low_differs_next) == std::strong_ordering::less);
+    assert((-low_differs <=> -low_differs_next) == std::strong_ordering::greater);
+    assert((low_differs <=> BigInteger(low_differs)) == std::strong_ordering::equal);
+    assert((-low_differs <=> -low_differs) == std::strong_ordering::equal && !BigInteger::isLess(-low_differs, -low_differs));
+    assert((BigInteger(0) <=> -BigInteger(0)) == std::strong_ordering::equal && BigInteger(-1) < BigInteger(0));
+    assert(-low_differs < BigInteger(-1) && BigInteger(-1) < low_differs && low_differs > BigInteger(1) << 299);
+    assert(low_differs <= low_differs && low_differs >= low_differs && low_differs != low_differs_next);
+    // Порядок после сортировки совпадает с порядком разностей
+    std::vector<BigInteger> ordered;
+    for (size_t length : { 1, 2, 16, 17, 40 }) {
+        ordered.push_back(random_hex(length));
+        ordered.push_back(-random_hex(length));
+        ordered.push_back(ordered.back() + 1);
+    }
+    ordered.push_back(0);
+    std::sort(ordered.begin(), ordered.end());
+    for (size_t i = 1; i < ordered.size(); ++i) {
+        assert((ordered[i] - ordered[i - 1]).sign() >= 0);
+        assert(((ordered[i - 1] <=> ordered[i]) < 0) == ((ordered[i] - ordered[i - 1]).sign() > 0));
+    }
+
+    // ================== MEMORY RESOURCE TESTS ==================
+    [[maybe_unused]] std::pmr::memory_resource* const library_resource = BigInteger::default_memory_resource();
+    BigInteger outside = random_hex(100);
+    {
+        const MemoryResourceScope scope(&counting);
+        assert(BigInteger::default_memory_resource() == &counting);
+        BigInteger inside = outside * outside + random_hex(300);
+        assert(inside.get_memory_resource() == &counting && counting.allocations > 0 && counting.live_bytes > 0);
+        // Число, созданное вне области, продолжает брать память из своего источника
+        [[maybe_unused]] const size_t before = counting.allocations;
+        outside <<= 2000;
+        assert(outside.get_memory_resource() == library_resource && counting.allocations == before);
+        // Перемещение между разными источниками копирует лимбы
+        const BigInteger expected = inside;
+        outside = std::move(inside);
+        assert(outside.get_memory_resource() == library_resource && outside == expected);
+        BigInteger printed(to_string(outside));
+        assert(printed == outside && printed.get_memory_resource() == &counting);
+    }
+    assert(counting.live_bytes == 0 && BigInteger::default_memory_resource() == library_resource);
+    // Все временные числа из монотонного буфера, результат - в обычной памяти
+    BigInteger arena_result;
+    {
+        std::pmr::monotonic_buffer_resource arena;
+        const MemoryResourceScope scope(&arena);
+        BigInteger power = 1;
+        for (int i = 0; i < 200; ++i) {
+            power *= 1000000007;
+        }
+        arena_result = BigInteger(to_string(power)) % 998244353;
+    }
+    assert(to_string(arena_result) == to_string(pow_mod(1000000007, 200, 998244353)));
+    BigInteger explicit_resource(&counting);
+    explicit_resource = random_hex(80);
+    assert(explicit_resource.get_memory_resource() == &counting && counting.live_bytes > 0);
+    explicit_resource = 0;
+    explicit_resource.shrink_to_fit();
+    assert(counting.live_bytes == 0);
+    // mul_add строит результат в одном буфере, как и обычное произведение
+    {
+        const BigInteger fa = random_hex(150);
+        const BigInteger fb = -random_hex(100);
+        const BigInteger fc = random_hex(260);
+        const MemoryResourceScope scope(&counting);
+        size_t before = counting.allocations;
+        const BigInteger product_only = fa * fb;
+        [[maybe_unused]] const size_t product_allocations = counting.allocations - before;
+        before = counting.allocations;
+        const BigInteger fused_result = mul_add(fa, fb, fc);
+        assert(counting.allocations - before == 1 && product_allocations == 1);
+        assert(fused_result == product_only + fc);
+        // Небольшое произведение addmul держит на стеке, большое - в буфере из текущего источника
+        BigInteger accumulated = fc;
+        accumulated.reserve(fused_result.get_size() + 4);
+        before = counting.allocations;
+        accumulated.addmul(fa, fb);
+        assert(counting.allocations == before && accumulated == fused_result);
+        const BigInteger wide = random_hex(1200);
+        accumulated.reserve(wide.get_size() + fb.get_size() + 4);
+        before = counting.allocations;
+        accumulated.addmul(wide, fb);
+        assert(counting.allocations > before);
+        assert(accumulated == fused_result + wide * fb);
+    }
+    assert(counting.live_bytes == 0);
+    // Умножение на один лимб растит буфер в полтора раза: перевыделений O(log n), а не по одному на лимб
+    {
+        const MemoryResourceScope scope(&counting);
+        BigInteger grown_small = 1;
+        BigInteger grown_big = 1;
+        [[maybe_unused]] const size_t before = counting.allocations;
+        for (int i = 0; i < 2000; ++i) {
+            grown_small *= 3;
+            grown_big *= BigInteger(3);
+        }
+        assert(counting.allocations - before <= 20 && grown_small == grown_big && grown_small % 3 == 0);
+    }
+
+    // Результат двухлимбовых операндов остаётся во встроенном буфере: ни одного выделения
+    {
+        const BigInteger two_70 = BigInteger(1) << 70;
+        const BigInteger five = 5;
+        const BigInteger expected_sum = two_70 + five;
+        const MemoryResourceScope scope(&counting);
+        [[maybe_unused]] const size_t before = counting.allocations;
+        const BigInteger inline_sum = two_70 + five;
+        const BigInteger inline_difference = two_70 - five;
+        const BigInteger inline_shift = two_70 << 1;
+        const BigInteger inline_product = two_70 * 3;
+        const BigInteger inline_fused = mul_add(two_70, five, five);
+        assert(counting.allocations == before);
+        assert(inline_sum == expected_sum && inline_difference + 10 == expected_sum && inline_shift == two_70 * 2);
+        assert(inline_product == inline_shift + two_70 && inline_fused == 5 * expected_sum - 20);
+    }
+    // from_chars собирает число в буфере цели: повторный разбор в заранее выделенное число не выделяет память
+    {
+        const std::string decimal_text = "-" + std::string(60, '7');
+        const std::string hex_text(40, 'f');
+        const BigInteger decimal_value(decimal_text);
+        const BigInteger hex_value = (BigInteger(1) << 160) - 1;
+        const MemoryResourceScope scope(&counting);
+        BigInteger target;
+        target.reserve(16);
+        [[maybe_unused]] const size_t before = counting.allocations;
+        for (int i = 0; i < 100; ++i) {
+            from_chars(decimal_text.data(), decimal_text.data() + decimal_text.size(), target);
+            assert(target == decimal_value);
+            from_chars(hex_text.data(), hex_text.data() + hex_text.size(), target, 16);
+            assert(target == hex_value);
+        }
+        from_chars(decimal_text.data(), decimal_text.data() + decimal_text.size(), target);
+        assert(counting.allocations == before && target.get_is_negative());
+    }
+
+    // ================== LIMB POOL TESTS ==================
+    const BigInteger pool_dividend = random_hex(2000);
+    const BigInteger pool_divisor = random_hex(700);
+    BigInteger pool_quotient = pool_dividend / pool_divisor;
+    [[maybe_unused]] const biginteger_pool_statistics warm = BigInteger::pool_statistics();
+    for (int i = 0; i < 10; ++i) {
+        pool_quotient = pool_dividend / pool_divisor + to_string(pool_dividend % pool_divisor).size();
+    }
+    [[maybe_unused]] const biginteger_pool_statistics hot = BigInteger::pool_statistics();
+    // Повторные деления и печать берут буферы из кэша потока
+    assert(hot.hits > warm.hits && hot.misses - warm.misses < hot.hits - warm.hits);
+    assert(pool_quotient == pool_dividend / pool_divisor + to_string(pool_dividend % pool_divisor).size());
+    BigInteger::set_pool_limit(0);
+    {
+        BigInteger released = pool_dividend * pool_dividend;
+    }
+    assert(BigInteger::pool_statistics().cached_bytes <= hot.cached_bytes);
+    BigInteger::set_pool_limit(size_t(4) << 20);
+    {
+        BigInteger cached = pool_dividend * pool_divisor;
+    }
+    assert(BigInteger::pool_statistics().cached_bytes > 0);
+
+    // ================== BITWISE TESTS ==================
+    BigInteger bits_a("123456789ABCDEF0123456789ABCDEF0123", biginteger_base::hex);
+    BigInteger bits_b("-FEDCBA9876543210FEDCBA987654321", biginteger_base::hex);
+    assert(to_hex(bits_a & bits_b) == "12340020002488A000240020002488A0003");
+    assert(to_hex(bits_a | bits_b) == "-A884200020042000A88420002004201");
+    assert(to_hex(bits_a ^ bits_b) == "-1234A8A42024A8A42024A8A42024A8A4204");
+    assert(to_hex(-bits_a & bits_b) == "-1234FEFCBABCFEF43234FEFCBABCFEF4323");
+    assert(to_hex(-bits_a | bits_b) == "-56589A985650121056589A985650121");
+    assert(to_hex(-bits_a ^ -bits_b) == "-1234A8A42024A8A42024A8A42024A8A4204");
+    assert((BigInteger(12) & 10) == 8 && (BigInteger(12) | 3) == 15 && (BigInteger(12) ^ 12) == 0);
+    assert(~BigInteger(0) == -1 && ~BigInteger(-1) == 0 && ~bits_a == -bits_a - 1);
+    assert((BigInteger(1) << 200) == BigInteger("1606938044258990275541962092341162602522202993782792835301376"));
+    assert((bits_a << 0) == bits_a && (bits_a << 64) >> 64 == bits_a && (bits_a >> 137) == 0);
+    BigInteger shifted_negative = -(BigInteger(1) << 130) - 5;
+    assert(to_hex(shifted_negative >> 3) == "-80000000000000000000000000000001");
+    assert((shifted_negative >> 130) == -2 && (-(BigInteger(1) << 130) >> 130) == -1);
+    assert((BigInteger(-1) >> 1000) == -1 && (BigInteger(5) >> 1000) == 0 && (BigInteger(-8) >> 3) == -1);
+    BigInteger shift_target = bits_a;
+    shift_target <<= 67;
+    assert(shift_target == bits_a * (BigInteger(1) << 67));
+    shift_target >>= 67;
+    assert(shift_target == bits_a);
+    assert(bits_a.bit_length() == 137 && BigInteger(0).bit_length() == 0 && BigInteger(-1).bit_length() == 1);
+    assert(bits_a.popcount() == 68 && BigInteger(0).popcount() == 0 && BigInteger(-3).popcount() == SIZE_MAX);
+    assert(bits_a.test_bit(0) && !bits_a.test_bit(2) && !bits_a.test_bit(137) && !bits_a.test_bit(10000));
+    BigInteger negative_power = -(BigInteger(1) << 64);
+    assert(!negative_power.test_bit(0) && !negative_power.test_bit(63) && negative_power.test_bit(64));
+    assert(negative_power.test_bit(65) && negative_power.test_bit(200) && bits_b.test_bit(70) && bits_b.test_bit(1));
+    for (size_t length : { 3, 40, 700 }) {
+        BigInteger x = random_hex(length);
+        BigInteger y = -random_hex(length / 2 + 1);
+        for (int signs = 0; signs < 4; ++signs) {
+            BigInteger p = (signs & 1) ? -x : x;
+            BigInteger q = (signs & 2) ? -y : y;
+            assert((p & q) + (p | q) == p + q);
+            assert((p ^ q) == (p | q) - (p & q));
+            assert(((p ^ q) ^ q) == p && (p & ~p) == 0 && (p | ~p) == -1);
+        }
+        BigInteger quotient_by_shift = x >> 77;
+        assert(quotient_by_shift == x / (BigInteger(1) << 77) && (x << 77) == x * (BigInteger(1) << 77));
+        assert((-x >> 77) == -((x - 1) >> 77) - 1);
+    }
+
+    // ================== MODULAR POWER TESTS ==================
+    const BigInteger mersenne_127 = (BigInteger(1) << 127) - 1;
+    const BigInteger mersenne_521 = (BigInteger(1) << 521) - 1;
+    assert(to_string(pow_mod(3, BigInteger("10000000000000000000000000000000000000007"), mersenne_127)) ==
+        "32959670296960619395375032109508928491");
+    assert(to_string(pow_mod(BigInteger("-12345678901234567891"), BigInteger("987654321987654321"),
+        BigInteger("10000000000000000000000000000000000000000"))) == "2793875348815693548731690805705253571309");
+    assert(pow_mod(5, 117, 96) == 53 && pow_mod(7, 0, 1) == 0 && pow_mod(7, 0, 10) == 1 && pow_mod(-1, 3, 8) == 7);
+    // Малая теорема Ферма: a^(p-2) - обратный к a по простому модулю
+    const BigInteger fermat_base = (BigInteger(1) << 300) + 5;
+    assert(pow_mod(fermat_base, mersenne_521 - 2, mersenne_521) * fermat_base % mersenne_521 == 1);
+    MontgomeryContext montgomery(mersenne_521);
+    assert(montgomery.modulus() == mersenne_521);
+    assert(montgomery.from_montgomery(montgomery.to_montgomery(fermat_base)) == fermat_base);
+    assert(montgomery.from_montgomery(montgomery.multiply(montgomery.to_montgomery(fermat_base),
+        montgomery.to_montgomery(-fermat_base))) == mersenne_521 - fermat_base * fermat_base % mersenne_521);
+    for (size_t length : { 1, 16, 50, 200 }) {
+        const BigInteger odd_modulus = random_hex(length) | 1;
+        const BigInteger base = -random_hex(length + 5);
+        const BigInteger exponent = random_hex(8);
+        // Проверка против возведения с делением на каждом шаге
+        BigInteger expected = 1;
+        for (size_t i = exponent.bit_length(); i-- > 0;) {
+            expected = expected * expected % odd_modulus;
+            if (exponent.test_bit(i)) {
+                expected = expected * base % odd_modulus;
+            }
+        }
+        if (expected.get_is_negative()) {
+            expected += odd_modulus;
+        }
+        assert(pow_mod(base, exponent, odd_modulus) == expected);
+        const BigInteger even_modulus = odd_modulus << 70;
+        const BigInteger even_result = pow_mod(base, exponent, even_modulus);
+        assert(even_result % odd_modulus == expected && even_result < even_modulus);
+        assert(even_result % (BigInteger(1) << 70) == pow_mod(base, exponent, BigInteger(1) << 70));
+    }
+    for (const BigInteger& invalid : { BigInteger(0), BigInteger(-7) }) {
+        try {
+            pow_mod(2, 3, invalid);
+            assert(false);
+        }
+        catch (const std::invalid_argument&) {
+            // ожидаем исключение
+        }
+    }
+    try {
+        MontgomeryContext even_context(BigInteger(10));
+        assert(false);
+    }
+    catch (const std::invalid_argument&) {
+        // ожидаем исключение
+    }
+
+    // ================== BARRETT REDUCTION TESTS ==================
+    const BigInteger curve_prime = (BigInteger(1) << 255) - 19;
+    BarrettReducer barrett(curve_prime);
+    assert(barrett.modulus() == curve_prime);
+    assert(barrett.reduce((curve_prime - 1) * (curve_prime - 1)) == 1 && barrett.reduce(curve_prime) == 0);
+    assert(to_string(barrett.reduce(-pow_mod(3, 300, curve_prime * curve_prime))) ==
+        "28219431514985122117833886084735307524385876733850097651679271314144305827755");
+    assert(to_string(barrett.reduce((BigInteger(1) << 600) + 12345)) == "446896354182022279238583857209");
+    assert(barrett.reduce(0) == 0 && barrett.reduce(-5) == curve_prime - 5 && barrett.reduce(17) == 17);
+    for (size_t length : { 1, 16, 17, 90, 400 }) {
+        BarrettReducer reducer(random_hex(length));
+        std::vector<BigInteger> values;
+        for (size_t digits : { size_t(1), length, length + 1, 2 * length - 1, 2 * length + 20, 4 * length + 40 }) {
+            values.push_back(random_hex(digits));
+            values.push_back(-random_hex(digits));
+        }
+        std::vector<BigInteger> reduced = values;
+        reducer.reduce(reduced);
+        for (size_t i = 0; i < values.size(); ++i) {
+            BigInteger expected = values[i] % reducer.modulus();
+            if (expected.get_is_negative()) {
+                expected += reducer.modulus();
+            }
+            assert(reduced[i] == expected && reducer.reduce(values[i]) == expected);
+        }
+    }
+    try {
+        BarrettReducer zero_modulus(0);
+        assert(false);
+    }
+    catch (const std::invalid_argument&) {
+        // ожидаем исключение
+    }
+
+    // ================== GCD TESTS ==================
+    const BigInteger gcd_a = BigInteger("12345678901234567890123456789");
+    const BigInteger gcd_b = BigInteger("98765432109876543210");
+    assert(gcd(gcd_a, gcd_b) == 9 && gcd(-gcd_a, gcd_b) == 9 && gcd(gcd_b, -gcd_a) == 9);
+    assert(gcd(0, 0) == 0 && gcd(0, -15) == 15 && gcd(1, gcd_a) == 1 && gcd(gcd_a, gcd_a) == gcd_a);
+    const BigInteger common_factor = pow_mod(3, 60, BigInteger(1) << 200) + 1;
+    assert(to_string(gcd(((BigInteger(1) << 400) + (BigInteger(1) << 200) * pow_mod(3, 50, BigInteger(1) << 200)) * common_factor,
+        ((BigInteger(1) << 350) + 7) * (pow_mod(3, 100, BigInteger(1) << 200) + 11) * common_factor)) ==
+        "169564633100864814057177732808");
+    assert(to_string(lcm((BigInteger(1) << 70) * 243, (BigInteger(1) << 10) * pow_mod(3, 40, BigInteger(1) << 100) * -5)) ==
+        "71766189842240549344861111084718877573120");
+    assert(lcm(0, 5) == 0 && lcm(-4, 6) == 12);
+    assert(to_string(mod_inverse(-12345, mersenne_127)) == "148613396618407430195446269418256647392");
+    assert(mod_inverse(3, 7) == 5 && mod_inverse(10, 1) == 0);
+    try {
+        mod_inverse(gcd_a, gcd_b);
+        assert(false);
+    }
+    catch (const std::invalid_argument&) {
+        // ожидаем исключение
+    }
+    BigInteger g_value;
+    BigInteger s_value;
+    BigInteger t_value;
+    xgcd(0, -7, g_value, s_value, t_value);
+    assert(g_value == 7 && s_value == 0 && t_value == -1);
+    xgcd(-7, 0, g_value, s_value, t_value);
+    assert(g_value == 7 && s_value == -1 && t_value == 0);
+    // Лемер и половинный НОД (с пониженным порогом) против алгоритма Евклида с делением
+    for (size_t half_gcd_limbs : { size_t(4), size_t(600) }) {
+        BigInteger::thresholds().half_gcd = half_gcd_limbs;
+        for (size_t length : { 3, 20, 33, 300, 1500 }) {
+            const BigInteger factor = random_hex(length / 3 + 1);
+            const BigInteger x = random_hex(length) * factor;
+            const BigInteger y = -random_hex(length * 2 / 3 + 1) * factor;
+            BigInteger expected = x;
+            BigInteger other = y.abs();
+            while (!other.isZero()) {
+                BigInteger rest = expected % other;
+                expected = other;
+                other = rest;
+            }
+            assert(gcd(x, y) == expected && gcd(y, x) == expected);
+            xgcd(x, y, g_value, s_value, t_value);
+            assert(g_value == expected && s_value * x + t_value * y == expected);
+            assert(s_value.abs() * 2 * expected <= y.abs());
+            xgcd(y, x, g_value, s_value, t_value);
+            assert(g_value == expected && s_value * y + t_value * x == expected);
+            const BigInteger unit = x / expected;
+            const BigInteger modulus = y.abs() / expected;
+            assert(unit * mod_inverse(unit, modulus) % modulus == (modulus == 1 ? 0 : 1));
+        }
+    }
+    BigInteger::thresholds() = saved_thresholds;
+
+    // ================== ROOT TESTS ==================
+    const BigInteger googol_plus = BigInteger("1" + std::string(100, '0')) + 12345;
+    BigInteger root_value;
+    BigInteger root_remainder;
+    sqrtrem(googol_plus, root_value, root_remainder);
+    assert(root_value == BigInteger("1" + std::string(50, '0')) && root_remainder == 12345);
+    assert(isqrt(0) == 0 && isqrt(1) == 1 && isqrt(15) == 3 && isqrt(16) == 4);
+    assert(to_string(iroot(pow_mod(3, 1000, BigInteger(1) << 2000), 7)) ==
+        "144603646791632930926159927261170946283087621411912736405297903792851");
+    assert(iroot((BigInteger(1) << 4000) + 1, 5) == (BigInteger(1) << 800));
+    assert(iroot(-27, 3) == -3 && iroot(-28, 3) == -3 && iroot(26, 3) == 2 && iroot(5, 1) == 5 && iroot(1000, 100) == 1);
+    // Показатель не меньше длины числа в битах: корень 1 без построения 2^k
+    assert(iroot(5, 5000000) == 1 && iroot(-5, 5000001) == -1 && iroot(random_hex(500), 1UL << 40) == 1);
+    assert(iroot(BigInteger(1) << 100, 100) == 2 && iroot((BigInteger(1) << 100) - 1, 100) == 1);
+    assert(iroot((BigInteger(1) << 100) - 1, 99) == 2 && iroot((BigInteger(1) << 99) - 1, 99) == 1);
+    assert(is_perfect_square(0) && is_perfect_square(1) && !is_perfect_square(2) && !is_perfect_square(-4));
+    assert(is_perfect_square(googol_plus - 12345) && !is_perfect_square(googol_plus));
+    for (size_t length : { 5, 31, 32, 33, 200, 2000 }) {
+        const BigInteger x = random_hex(length);
+        sqrtrem(x, root_value, root_remainder);
+        assert(root_value * root_value + root_remainder == x && root_remainder <= 2 * root_value);
+        const BigInteger square_value = root_value.square();
+        assert(is_perfect_square(square_value) && !is_perfect_square(square_value + 1) && isqrt(square_value - 1) == root_value - 1);
+        for (unsigned long k : { 3ul, 4ul, 17ul }) {
+            const BigInteger r = iroot(x, k);
+            BigInteger low = 1;
+            BigInteger high = 1;
+            for (unsigned long i = 0; i < k; ++i) {
+                low *= r;
+                high *= r + 1;
+            }
+            assert(low <= x && x < high);
+        }
+    }
+    for (unsigned long k : { 0ul, 2ul }) {
+        try {
+            iroot(-16, k);
+            assert(false);
+        }
+        catch (const std::invalid_argument&) {
+            // ожидаем исключение
+        }
+    }
+
+    // ================== COMBINATORICS TESTS ==================
+    assert(factorial(0) == 1 && factorial(1) == 1 && factorial(20) == BigInteger(2432902008176640000ull));
+    assert(to_string(factorial(30)) == "265252859812191058636308480000000");
+    assert(to_string(factorial(1000) % mersenne_127) == "143876027850438580052708853018769073699");
+    assert(to_string(binomial(200, 77)) == "447227436580530834572725174156417227418739739693795984000");
+    assert(to_string(binomial(10000, 3333) % mersenne_127) == "82733318568220470845813457120952816540");
+    assert(binomial(5, 7) == 0 && binomial(7, 0) == 1 && binomial(7, 7) == 1 && binomial(0, 0) == 1);
+    assert(to_string(primorial(100)) == "2305567963945518424753102147331756070");
+    assert(primorial(0) == 1 && primorial(1) == 1 && primorial(2) == 2 && primorial(30) == 6469693230);
+    BigInteger running_factorial = 1;
+    for (unsigned long n = 1; n <= 300; ++n) {
+        running_factorial *= BigInteger(n);
+        if (n % 37 == 0 || n == 300) {
+            assert(factorial(n) == running_factorial);
+            assert(binomial(n, n / 3) * factorial(n / 3) * factorial(n - n / 3) == running_factorial);
+        }
+    }
+
+    // ================== KERNEL VARIANT TESTS ==================
+    const std::string detected_variant = BigInteger::kernel_variant();
+    BigInteger::set_kernel_variant("generic");
+    assert(BigInteger::kernel_variant() == "generic");
+    BigInteger kernel_a = random_hex(333);
+    BigInteger kernel_b = -random_hex(170);
+    const BigInteger kernel_product = kernel_a * kernel_b;
+    const BigInteger kernel_quotient = kernel_a / kernel_b;
+    const BigInteger kernel_remainder = kernel_a % kernel_b;
+    const std::string kernel_text = to_string(kernel_product);
+    for (const char* variant : { "x86-64", "adx", "avx2", "avx512" }) {
+        try {
+            BigInteger::set_kernel_variant(variant);
+        }
+        catch (const std::invalid_argument&) {
+            continue;  // вариант не собран для этой платформы или не поддерживается процессором
+        }
+        assert(BigInteger::kernel_variant() == variant);
+        assert(kernel_a * kernel_b == kernel_product && to_string(kernel_product) == kernel_text);
+        assert(kernel_a / kernel_b == kernel_quotient && kernel_a % kernel_b == kernel_remainder);
+        assert(kernel_product - kernel_a * kernel_b + kernel_a == kernel_a && kernel_a > kernel_b);
+    }
+    try {
+        BigInteger::set_kernel_variant("sse5");
+        assert(false);
+    }
+    catch (const std::invalid_argument&) {
+        // ожидаем исключение
+    }
+    BigInteger::set_kernel_variant("auto");
+    BigInteger::set_kernel_variant(detected_variant);  // вариант из BIGINTEGER_KERNELS, если он задан
+
     // ================== FINAL CONFIRMATION ==================
     std::cout << "All tests passed successfully!" << std::endl;
 